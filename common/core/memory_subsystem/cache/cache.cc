@@ -1,5 +1,13 @@
 #include "simulator.h"
 #include "cache.h"
+#include "cache_set_lru.h"
+#include "cache_set_mru.h"
+#include "cache_set_nmru.h"
+#include "cache_set_nru.h"
+#include "cache_set_plru.h"
+#include "cache_set_random.h"
+#include "cache_set_round_robin.h"
+#include "cache_set_srrip.h"
 #include "log.h"
 
 // Cache class
@@ -19,16 +27,19 @@ Cache::Cache(
 :
    CacheBase(name, num_sets, associativity, cache_block_size, hash, ahl),
    m_enabled(false),
+   m_core_id(core_id),
    m_num_accesses(0),
    m_num_hits(0),
    m_cache_type(cache_type),
+   m_replacement_policy(CacheSet::parsePolicyType(replacement_policy)),
    m_fault_injector(fault_injector)
 {
+   UInt8 num_attempts = CacheSet::getNumQBSAttempts(m_replacement_policy, cfgname, core_id);
    m_set_info = CacheSet::createCacheSetInfo(name, cfgname, core_id, replacement_policy, m_associativity);
    m_sets = new CacheSet*[m_num_sets];
    for (UInt32 i = 0; i < m_num_sets; i++)
    {
-      m_sets[i] = CacheSet::createCacheSet(cfgname, core_id, replacement_policy, m_cache_type, m_associativity, m_blocksize, m_set_info);
+      m_sets[i] = CacheSet::createCacheSet(cfgname, core_id, m_replacement_policy, num_attempts, m_cache_type, m_associativity, m_blocksize, m_set_info);
    }
 
    #ifdef ENABLE_SET_USAGE_HIST
@@ -36,10 +47,16 @@ Cache::Cache(
    for (UInt32 i = 0; i < m_num_sets; i++)
       m_set_usage_hist[i] = 0;
    #endif
+
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->registerObject(m_name, m_core_id, this);
 }
 
 Cache::~Cache()
 {
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->unregisterObject(m_name, m_core_id);
+
    #ifdef ENABLE_SET_USAGE_HIST
    printf("Cache %s set usage:", m_name.c_str());
    for (SInt32 i = 0; i < (SInt32) m_num_sets; i++)
@@ -105,20 +122,68 @@ Cache::accessSingleLine(IntPtr addr, access_t access_type,
       if (m_fault_injector)
          m_fault_injector->preRead(addr, set_index * m_associativity + line_index, bytes, (Byte*)m_sets[set_index]->getDataPtr(line_index, block_offset), now);
 
-      set->read_line(line_index, block_offset, buff, bytes, update_replacement);
+      set->read_line(line_index, block_offset, buff, bytes, false);
    }
    else
    {
-      set->write_line(line_index, block_offset, buff, bytes, update_replacement);
+      set->write_line(line_index, block_offset, buff, bytes, false);
 
       // NOTE: assumes error occurs in memory. If we want to model bus errors, insert the error into buff instead
       if (m_fault_injector)
          m_fault_injector->postWrite(addr, set_index * m_associativity + line_index, bytes, (Byte*)m_sets[set_index]->getDataPtr(line_index, block_offset), now);
    }
 
+   if (update_replacement)
+      updateReplacementIndex(set, line_index);
+
    return cache_block_info;
 }
 
+template <class T> static inline void updateReplacementIndexPolicy(CacheSet* set, UInt32 line_index)
+{
+   // T is final, so this call is resolved statically and inlined
+   static_cast<T*>(set)->updateReplacementIndex(line_index);
+}
+
+// Replacement update on a hit. The policy was fixed when this cache was constructed,
+// so the switch always takes the same (well-predicted) branch instead of a virtual call per access
+void
+Cache::updateReplacementIndex(CacheSet* set, UInt32 line_index)
+{
+   switch(m_replacement_policy)
+   {
+      case ROUND_ROBIN:
+         updateReplacementIndexPolicy<CacheSetRoundRobin>(set, line_index);
+         break;
+      case LRU:
+      case LRU_QBS:
+         updateReplacementIndexPolicy<CacheSetLRU>(set, line_index);
+         break;
+      case NRU:
+         updateReplacementIndexPolicy<CacheSetNRU>(set, line_index);
+         break;
+      case MRU:
+         updateReplacementIndexPolicy<CacheSetMRU>(set, line_index);
+         break;
+      case NMRU:
+         updateReplacementIndexPolicy<CacheSetNMRU>(set, line_index);
+         break;
+      case PLRU:
+         updateReplacementIndexPolicy<CacheSetPLRU>(set, line_index);
+         break;
+      case SRRIP:
+      case SRRIP_QBS:
+         updateReplacementIndexPolicy<CacheSetSRRIP>(set, line_index);
+         break;
+      case RANDOM:
+         updateReplacementIndexPolicy<CacheSetRandom>(set, line_index);
+         break;
+      default:
+         set->updateReplacementIndex(line_index);
+         break;
+   }
+}
+
 void
 Cache::insertSingleLine(IntPtr addr, Byte* fill_buff,
       bool* eviction, IntPtr* evict_addr,
@@ -169,9 +234,10 @@ Cache::updateCounters(bool cache_hit)
 {
    if (m_enabled)
    {
-      m_num_accesses ++;
+      // Atomic, slices of a shared cache are updated concurrently
+      __sync_fetch_and_add(&m_num_accesses, 1);
       if (cache_hit)
-         m_num_hits ++;
+         __sync_fetch_and_add(&m_num_hits, 1);
    }
 }
 
@@ -180,7 +246,28 @@ Cache::updateHits(Core::mem_op_t mem_op_type, UInt64 hits)
 {
    if (m_enabled)
    {
-      m_num_accesses += hits;
-      m_num_hits += hits;
+      __sync_fetch_and_add(&m_num_accesses, hits);
+      __sync_fetch_and_add(&m_num_hits, hits);
    }
 }
+
+void
+Cache::saveCheckpoint(std::ostream &os)
+{
+   CheckpointManager::write(os, m_num_sets);
+   CheckpointManager::write(os, m_associativity);
+   for (UInt32 i = 0; i < m_num_sets; i++)
+      m_sets[i]->saveState(os);
+}
+
+void
+Cache::loadCheckpoint(std::istream &is)
+{
+   UInt32 num_sets = CheckpointManager::read<UInt32>(is);
+   UInt32 associativity = CheckpointManager::read<UInt32>(is);
+   LOG_ASSERT_ERROR(num_sets == m_num_sets && associativity == m_associativity,
+                    "Cache %s: checkpoint has %u sets of %u ways, configured for %u sets of %u ways",
+                    m_name.c_str(), num_sets, associativity, m_num_sets, m_associativity);
+   for (UInt32 i = 0; i < m_num_sets; i++)
+      m_sets[i]->loadState(is);
+}
@@ -11,14 +11,16 @@
 #include "log.h"
 #include "core.h"
 #include "fault_injection.h"
+#include "checkpoint_manager.h"
 
 // Define to enable the set usage histogram
 //#define ENABLE_SET_USAGE_HIST
 
-class Cache : public CacheBase
+class Cache : public CacheBase, public Checkpointable
 {
    private:
       bool m_enabled;
+      core_id_t m_core_id;
 
       // Cache counters
       UInt64 m_num_accesses;
@@ -26,6 +28,7 @@ class Cache : public CacheBase
 
       // Generic Cache Info
       cache_t m_cache_type;
+      ReplacementPolicy m_replacement_policy;
       CacheSet** m_sets;
       CacheSetInfo* m_set_info;
 
@@ -35,6 +38,8 @@ class Cache : public CacheBase
       UInt64* m_set_usage_hist;
       #endif
 
+      void updateReplacementIndex(CacheSet* set, UInt32 line_index);
+
    public:
 
       // constructors/destructors
@@ -68,6 +73,10 @@ class Cache : public CacheBase
 
       void enable() { m_enabled = true; }
       void disable() { m_enabled = false; }
+
+      // Checkpointable: tags, coherence state and replacement state of all sets
+      void saveCheckpoint(std::ostream &os);
+      void loadCheckpoint(std::istream &is);
 };
 
 template <class T>
@@ -3,6 +3,7 @@
 #include "pr_l2_cache_block_info.h"
 #include "shared_cache_block_info.h"
 #include "log.h"
+#include "checkpoint_manager.h"
 
 const char* CacheBlockInfo::option_names[] =
 {
@@ -26,7 +27,8 @@ CacheBlockInfo::CacheBlockInfo(IntPtr tag, CacheState::cstate_t cstate, UInt64 o
    m_cstate(cstate),
    m_owner(0),
    m_used(0),
-   m_options(options)
+   m_options(options),
+   m_tag_slot(NULL)
 {}
 
 CacheBlockInfo::~CacheBlockInfo()
@@ -55,20 +57,40 @@ CacheBlockInfo::create(CacheBase::cache_t cache_type)
 void
 CacheBlockInfo::invalidate()
 {
-   m_tag = ~0;
+   storeTag(~0);
    m_cstate = CacheState::INVALID;
 }
 
 void
 CacheBlockInfo::clone(CacheBlockInfo* cache_block_info)
 {
-   m_tag = cache_block_info->getTag();
+   storeTag(cache_block_info->getTag());
    m_cstate = cache_block_info->getCState();
    m_owner = cache_block_info->m_owner;
    m_used = cache_block_info->m_used;
    m_options = cache_block_info->m_options;
 }
 
+void
+CacheBlockInfo::saveState(std::ostream &os) const
+{
+   CheckpointManager::write(os, m_tag);
+   CheckpointManager::write(os, m_cstate);
+   CheckpointManager::write(os, m_owner);
+   CheckpointManager::write(os, m_used);
+   CheckpointManager::write(os, m_options);
+}
+
+void
+CacheBlockInfo::loadState(std::istream &is)
+{
+   storeTag(CheckpointManager::read<IntPtr>(is));
+   m_cstate = CheckpointManager::read<CacheState::cstate_t>(is);
+   m_owner = CheckpointManager::read<UInt64>(is);
+   m_used = CheckpointManager::read<BitsUsedType>(is);
+   m_options = CheckpointManager::read<UInt8>(is);
+}
+
 bool
 CacheBlockInfo::updateUsage(UInt32 offset, UInt32 size)
 {
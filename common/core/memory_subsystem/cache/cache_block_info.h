@@ -5,6 +5,8 @@
 #include "cache_state.h"
 #include "cache_base.h"
 
+#include <iostream>
+
 class CacheBlockInfo
 {
    public:
@@ -26,9 +28,12 @@ class CacheBlockInfo
       UInt64 m_owner;
       BitsUsedType m_used;
       UInt8 m_options;  // large enough to hold a bitfield for all available option_t's
+      IntPtr* m_tag_slot; // Copy of m_tag in the owning CacheSet's packed tag array, if any
 
       static const char* option_names[];
 
+      void storeTag(IntPtr tag) { m_tag = tag; if (m_tag_slot) *m_tag_slot = tag; }
+
    public:
       CacheBlockInfo(IntPtr tag = ~0,
             CacheState::cstate_t cstate = CacheState::INVALID,
@@ -40,12 +45,16 @@ class CacheBlockInfo
       virtual void invalidate(void);
       virtual void clone(CacheBlockInfo* cache_block_info);
 
+      virtual void saveState(std::ostream &os) const;
+      virtual void loadState(std::istream &is);
+
       bool isValid() const { return (m_tag != ((IntPtr) ~0)); }
 
       IntPtr getTag() const { return m_tag; }
       CacheState::cstate_t getCState() const { return m_cstate; }
 
-      void setTag(IntPtr tag) { m_tag = tag; }
+      void setTag(IntPtr tag) { storeTag(tag); }
+      void setTagSlot(IntPtr* slot) { m_tag_slot = slot; *slot = m_tag; }
       void setCState(CacheState::cstate_t cstate) { m_cstate = cstate; }
 
       UInt64 getOwner() const { return m_owner; }
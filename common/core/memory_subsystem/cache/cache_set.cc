@@ -12,15 +12,58 @@
 #include "simulator.h"
 #include "config.h"
 #include "config.hpp"
+#include "checkpoint_manager.h"
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+# include <immintrin.h>
+#endif
+
+// Number of tags compared by a single matchTags() call
+#if defined(__AVX2__) && defined(__x86_64__)
+static const UInt32 TAGS_PER_VECTOR = 4;
+#elif defined(__SSE2__)
+static const UInt32 TAGS_PER_VECTOR = 16 / sizeof(IntPtr);
+#else
+static const UInt32 TAGS_PER_VECTOR = 1;
+#endif
+
+// Compare TAGS_PER_VECTOR consecutive (aligned) tags against tag, bit i of the result is set when tags[i] matches
+static inline UInt32 matchTags(const IntPtr* tags, IntPtr tag)
+{
+#if defined(__AVX2__) && defined(__x86_64__)
+   __m256i eq = _mm256_cmpeq_epi64(_mm256_load_si256((const __m256i*)tags), _mm256_set1_epi64x(tag));
+   return _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+#elif defined(__SSE2__) && defined(__x86_64__)
+   // No 64-bit compare in SSE2: both 32-bit halves of a lane need to match
+   __m128i eq = _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)tags), _mm_set1_epi64x(tag));
+   eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+   return _mm_movemask_pd(_mm_castsi128_pd(eq));
+#elif defined(__SSE2__)
+   __m128i eq = _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)tags), _mm_set1_epi32(tag));
+   return _mm_movemask_ps(_mm_castsi128_ps(eq));
+#else
+   return tags[0] == tag;
+#endif
+}
 
 CacheSet::CacheSet(CacheBase::cache_t cache_type,
       UInt32 associativity, UInt32 blocksize):
       m_associativity(associativity), m_blocksize(blocksize)
 {
+   UInt32 num_tags = (m_associativity + TAGS_PER_VECTOR - 1) / TAGS_PER_VECTOR * TAGS_PER_VECTOR;
+   __attribute__((unused)) int rc = posix_memalign((void**)&m_tags, 64, num_tags * sizeof(IntPtr));
+   LOG_ASSERT_ERROR(rc == 0, "posix_memalign failed to allocate memory");
+   for (UInt32 i = m_associativity; i < num_tags; i++)
+      m_tags[i] = ~0;
+
    m_cache_block_info_array = new CacheBlockInfo*[m_associativity];
    for (UInt32 i = 0; i < m_associativity; i++)
    {
       m_cache_block_info_array[i] = CacheBlockInfo::create(cache_type);
+      m_cache_block_info_array[i]->setTagSlot(&m_tags[i]);
    }
 
    if (Sim()->getFaultinjectionManager())
@@ -37,9 +80,37 @@ CacheSet::~CacheSet()
    for (UInt32 i = 0; i < m_associativity; i++)
       delete m_cache_block_info_array[i];
    delete [] m_cache_block_info_array;
+   free(m_tags);
    delete [] m_blocks;
 }
 
+void
+CacheSet::saveState(std::ostream &os) const
+{
+   for (UInt32 i = 0; i < m_associativity; i++)
+      m_cache_block_info_array[i]->saveState(os);
+   CheckpointManager::write<bool>(os, m_blocks != NULL);
+   if (m_blocks)
+      os.write(m_blocks, m_associativity * m_blocksize);
+   saveReplacementState(os);
+}
+
+void
+CacheSet::loadState(std::istream &is)
+{
+   for (UInt32 i = 0; i < m_associativity; i++)
+      m_cache_block_info_array[i]->loadState(is);
+   if (CheckpointManager::read<bool>(is))
+   {
+      // Data is only kept when fault injection is enabled, skip it when it isn't now
+      if (m_blocks)
+         is.read(m_blocks, m_associativity * m_blocksize);
+      else
+         is.ignore(m_associativity * m_blocksize);
+   }
+   loadReplacementState(is);
+}
+
 void
 CacheSet::read_line(UInt32 line_index, UInt32 offset, Byte *out_buff, UInt32 bytes, bool update_replacement)
 {
@@ -66,33 +137,43 @@ CacheSet::write_line(UInt32 line_index, UInt32 offset, Byte *in_buff, UInt32 byt
       updateReplacementIndex(line_index);
 }
 
-CacheBlockInfo*
-CacheSet::find(IntPtr tag, UInt32* line_index)
+// Returns the highest way holding tag, or -1 if there is none
+SInt32
+CacheSet::findWay(IntPtr tag) const
 {
-   for (SInt32 index = m_associativity-1; index >= 0; index--)
+   for (SInt32 base = (m_associativity - 1) / TAGS_PER_VECTOR * TAGS_PER_VECTOR; base >= 0; base -= TAGS_PER_VECTOR)
    {
-      if (m_cache_block_info_array[index]->getTag() == tag)
-      {
-         if (line_index != NULL)
-            *line_index = index;
-         return (m_cache_block_info_array[index]);
-      }
+      UInt32 mask = matchTags(&m_tags[base], tag);
+      // Ignore the padding after the last way
+      if (base + TAGS_PER_VECTOR > m_associativity)
+         mask &= (1u << (m_associativity - base)) - 1;
+      if (mask)
+         return base + 31 - __builtin_clz(mask);
    }
-   return NULL;
+   return -1;
+}
+
+CacheBlockInfo*
+CacheSet::find(IntPtr tag, UInt32* line_index)
+{
+   SInt32 index = findWay(tag);
+   if (index < 0)
+      return NULL;
+
+   if (line_index != NULL)
+      *line_index = index;
+   return (m_cache_block_info_array[index]);
 }
 
 bool
 CacheSet::invalidate(IntPtr& tag)
 {
-   for (SInt32 index = m_associativity-1; index >= 0; index--)
-   {
-      if (m_cache_block_info_array[index]->getTag() == tag)
-      {
-         m_cache_block_info_array[index]->invalidate();
-         return true;
-      }
-   }
-   return false;
+   SInt32 index = findWay(tag);
+   if (index < 0)
+      return false;
+
+   m_cache_block_info_array[index]->invalidate();
+   return true;
 }
 
 void
@@ -138,6 +219,15 @@ CacheSet::createCacheSet(String cfgname, core_id_t core_id,
       UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info)
 {
    CacheBase::ReplacementPolicy policy = parsePolicyType(replacement_policy);
+   return createCacheSet(cfgname, core_id, policy, getNumQBSAttempts(policy, cfgname, core_id), cache_type, associativity, blocksize, set_info);
+}
+
+CacheSet*
+CacheSet::createCacheSet(String cfgname, core_id_t core_id,
+      CacheBase::ReplacementPolicy policy, UInt8 num_attempts,
+      CacheBase::cache_t cache_type,
+      UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info)
+{
    switch(policy)
    {
       case CacheBase::ROUND_ROBIN:
@@ -145,7 +235,7 @@ CacheSet::createCacheSet(String cfgname, core_id_t core_id,
 
       case CacheBase::LRU:
       case CacheBase::LRU_QBS:
-         return new CacheSetLRU(cache_type, associativity, blocksize, dynamic_cast<CacheSetInfoLRU*>(set_info), getNumQBSAttempts(policy, cfgname, core_id));
+         return new CacheSetLRU(cache_type, associativity, blocksize, dynamic_cast<CacheSetInfoLRU*>(set_info), num_attempts);
 
       case CacheBase::NRU:
          return new CacheSetNRU(cache_type, associativity, blocksize);
@@ -161,7 +251,7 @@ CacheSet::createCacheSet(String cfgname, core_id_t core_id,
 
       case CacheBase::SRRIP:
       case CacheBase::SRRIP_QBS:
-         return new CacheSetSRRIP(cfgname, core_id, cache_type, associativity, blocksize, dynamic_cast<CacheSetInfoLRU*>(set_info), getNumQBSAttempts(policy, cfgname, core_id));
+         return new CacheSetSRRIP(cfgname, core_id, cache_type, associativity, blocksize, dynamic_cast<CacheSetInfoLRU*>(set_info), num_attempts);
 
       case CacheBase::RANDOM:
          return new CacheSetRandom(cache_type, associativity, blocksize);
@@ -9,6 +9,7 @@
 #include "log.h"
 
 #include <cstring>
+#include <iostream>
 
 // Per-cache object to store replacement-policy related info (e.g. statistics),
 // can collect data from all CacheSet* objects which are per set and implement the actual replacement policy
@@ -24,17 +25,24 @@ class CacheSet
    public:
 
       static CacheSet* createCacheSet(String cfgname, core_id_t core_id, String replacement_policy, CacheBase::cache_t cache_type, UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info = NULL);
+      static CacheSet* createCacheSet(String cfgname, core_id_t core_id, CacheBase::ReplacementPolicy policy, UInt8 num_attempts, CacheBase::cache_t cache_type, UInt32 associativity, UInt32 blocksize, CacheSetInfo* set_info = NULL);
       static CacheSetInfo* createCacheSetInfo(String name, String cfgname, core_id_t core_id, String replacement_policy, UInt32 associativity);
       static CacheBase::ReplacementPolicy parsePolicyType(String policy);
       static UInt8 getNumQBSAttempts(CacheBase::ReplacementPolicy, String cfgname, core_id_t core_id);
 
    protected:
       CacheBlockInfo** m_cache_block_info_array;
+      // Tags of all ways, kept contiguous (and padded to a whole number of vectors) so lookups
+      // can compare them all at once and only touch the CacheBlockInfo object on a hit.
+      // Invalid ways hold ~0, the CacheBlockInfo objects keep this array up to date.
+      IntPtr* m_tags;
       char* m_blocks;
       UInt32 m_associativity;
       UInt32 m_blocksize;
       Lock m_lock;
 
+      SInt32 findWay(IntPtr tag) const;
+
    public:
 
       CacheSet(CacheBase::cache_t cache_type,
@@ -60,6 +68,14 @@ class CacheSet
       virtual void updateReplacementIndex(UInt32) = 0;
 
       bool isValidReplacement(UInt32 index);
+
+      void saveState(std::ostream &os) const;
+      void loadState(std::istream &is);
+
+   protected:
+      // Policies with per-set replacement state override these to have it checkpointed along with the tags
+      virtual void saveReplacementState(std::ostream &os) const {}
+      virtual void loadReplacementState(std::istream &is) {}
 };
 
 #endif /* CACHE_SET_H */
@@ -1,6 +1,7 @@
 #include "cache_set_lru.h"
 #include "log.h"
 #include "stats.h"
+#include "checkpoint_manager.h"
 
 // Implements LRU replacement, optionally augmented with Query-Based Selection [Jaleel et al., MICRO'10]
 
@@ -77,24 +78,6 @@ CacheSetLRU::getReplacementIndex(CacheCntlr *cntlr)
    LOG_PRINT_ERROR("Should not reach here");
 }
 
-void
-CacheSetLRU::updateReplacementIndex(UInt32 accessed_index)
-{
-   m_set_info->increment(m_lru_bits[accessed_index]);
-   moveToMRU(accessed_index);
-}
-
-void
-CacheSetLRU::moveToMRU(UInt32 accessed_index)
-{
-   for (UInt32 i = 0; i < m_associativity; i++)
-   {
-      if (m_lru_bits[i] < m_lru_bits[accessed_index])
-         m_lru_bits[i] ++;
-   }
-   m_lru_bits[accessed_index] = 0;
-}
-
 CacheSetInfoLRU::CacheSetInfoLRU(String name, String cfgname, core_id_t core_id, UInt32 associativity, UInt8 num_attempts)
    : m_associativity(associativity)
    , m_attempts(NULL)
@@ -123,3 +106,15 @@ CacheSetInfoLRU::~CacheSetInfoLRU()
    if (m_attempts)
       delete [] m_attempts;
 }
+
+void
+CacheSetLRU::saveReplacementState(std::ostream &os) const
+{
+   os.write((const char*)m_lru_bits, m_associativity);
+}
+
+void
+CacheSetLRU::loadReplacementState(std::istream &is)
+{
+   is.read((char*)m_lru_bits, m_associativity);
+}
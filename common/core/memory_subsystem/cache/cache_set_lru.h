@@ -26,21 +26,37 @@ class CacheSetInfoLRU : public CacheSetInfo
       UInt64* m_attempts;
 };
 
-class CacheSetLRU : public CacheSet
+class CacheSetLRU final : public CacheSet
 {
    public:
       CacheSetLRU(CacheBase::cache_t cache_type,
             UInt32 associativity, UInt32 blocksize, CacheSetInfoLRU* set_info, UInt8 num_attempts);
       virtual ~CacheSetLRU();
 
-      virtual UInt32 getReplacementIndex(CacheCntlr *cntlr);
-      void updateReplacementIndex(UInt32 accessed_index);
+      UInt32 getReplacementIndex(CacheCntlr *cntlr);
+      void updateReplacementIndex(UInt32 accessed_index)
+      {
+         m_set_info->increment(m_lru_bits[accessed_index]);
+         moveToMRU(accessed_index);
+      }
 
    protected:
       const UInt8 m_num_attempts;
       UInt8* m_lru_bits;
       CacheSetInfoLRU* m_set_info;
-      void moveToMRU(UInt32 accessed_index);
+      void moveToMRU(UInt32 accessed_index)
+      {
+         for (UInt32 i = 0; i < m_associativity; i++)
+         {
+            if (m_lru_bits[i] < m_lru_bits[accessed_index])
+               m_lru_bits[i] ++;
+         }
+         m_lru_bits[accessed_index] = 0;
+      }
+
+   protected:
+      void saveReplacementState(std::ostream &os) const;
+      void loadReplacementState(std::istream &is);
 };
 
 #endif /* CACHE_SET_LRU_H */
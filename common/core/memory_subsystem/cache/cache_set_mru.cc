@@ -1,5 +1,6 @@
 #include "cache_set_mru.h"
 #include "log.h"
+#include "checkpoint_manager.h"
 
 // MRU: Most Recently Used
 
@@ -50,12 +51,13 @@ CacheSetMRU::getReplacementIndex(CacheCntlr *cntlr)
 }
 
 void
-CacheSetMRU::updateReplacementIndex(UInt32 accessed_index)
+CacheSetMRU::saveReplacementState(std::ostream &os) const
 {
-   for (UInt32 i = 0; i < m_associativity; i++)
-   {
-      if (m_lru_bits[i] < m_lru_bits[accessed_index])
-         m_lru_bits[i] ++;
-   }
-   m_lru_bits[accessed_index] = 0;
+   os.write((const char*)m_lru_bits, m_associativity);
+}
+
+void
+CacheSetMRU::loadReplacementState(std::istream &is)
+{
+   is.read((char*)m_lru_bits, m_associativity);
 }
@@ -3,7 +3,7 @@
 
 #include "cache_set.h"
 
-class CacheSetMRU : public CacheSet
+class CacheSetMRU final : public CacheSet
 {
    public:
       CacheSetMRU(CacheBase::cache_t cache_type,
@@ -11,10 +11,22 @@ class CacheSetMRU : public CacheSet
       ~CacheSetMRU();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
-      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndex(UInt32 accessed_index)
+      {
+         for (UInt32 i = 0; i < m_associativity; i++)
+         {
+            if (m_lru_bits[i] < m_lru_bits[accessed_index])
+               m_lru_bits[i]++;
+         }
+         m_lru_bits[accessed_index] = 0;
+      }
 
    private:
       UInt8* m_lru_bits;
+
+   protected:
+      void saveReplacementState(std::ostream &os) const;
+      void loadReplacementState(std::istream &is);
 };
 
 #endif /* CACHE_SET_MRU_H */
@@ -1,5 +1,6 @@
 #include "cache_set_nmru.h"
 #include "log.h"
+#include "checkpoint_manager.h"
 
 // NMRU: Not Most Recently Used
 
@@ -52,12 +53,15 @@ CacheSetNMRU::getReplacementIndex(CacheCntlr *cntlr)
 }
 
 void
-CacheSetNMRU::updateReplacementIndex(UInt32 accessed_index)
+CacheSetNMRU::saveReplacementState(std::ostream &os) const
 {
-   for (UInt32 i = 0; i < m_associativity; i++)
-   {
-      if (m_lru_bits[i] < m_lru_bits[accessed_index])
-         m_lru_bits[i]++;
-   }
-   m_lru_bits[accessed_index] = 0;
+   os.write((const char*)m_lru_bits, m_associativity);
+   CheckpointManager::write(os, m_replacement_pointer);
+}
+
+void
+CacheSetNMRU::loadReplacementState(std::istream &is)
+{
+   is.read((char*)m_lru_bits, m_associativity);
+   m_replacement_pointer = CheckpointManager::read<UInt8>(is);
 }
@@ -1,5 +1,6 @@
 #include "cache_set_nru.h"
 #include "log.h"
+#include "checkpoint_manager.h"
 
 // NRU: Not Recently Used. Some sort of Pseudo LRU policy.
 
@@ -66,20 +67,17 @@ CacheSetNRU::getReplacementIndex(CacheCntlr *cntlr)
 }
 
 void
-CacheSetNRU::updateReplacementIndex(UInt32 accessed_index)
+CacheSetNRU::saveReplacementState(std::ostream &os) const
 {
-   m_lru_bits[accessed_index] = 1;
-   m_num_bits_set++;
-
-   // If all lru bits are set to 1 in the set, we make all of them 0
-
-   if (m_num_bits_set == m_associativity)
-   {
-      m_num_bits_set = 0;
+   os.write((const char*)m_lru_bits, m_associativity);
+   CheckpointManager::write(os, m_num_bits_set);
+   CheckpointManager::write(os, m_replacement_pointer);
+}
 
-      for (UInt32 i = 0; i < m_associativity; i++)
-      {
-         m_lru_bits[i] = 0;
-      }
-   }
+void
+CacheSetNRU::loadReplacementState(std::istream &is)
+{
+   is.read((char*)m_lru_bits, m_associativity);
+   m_num_bits_set = CheckpointManager::read<UInt8>(is);
+   m_replacement_pointer = CheckpointManager::read<UInt8>(is);
 }
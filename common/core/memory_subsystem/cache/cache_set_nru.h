@@ -3,7 +3,7 @@
 
 #include "cache_set.h"
 
-class CacheSetNRU : public CacheSet
+class CacheSetNRU final : public CacheSet
 {
    public:
       CacheSetNRU(CacheBase::cache_t cache_type,
@@ -11,12 +11,28 @@ class CacheSetNRU : public CacheSet
       ~CacheSetNRU();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
-      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndex(UInt32 accessed_index)
+      {
+         m_lru_bits[accessed_index] = 1;
+         m_num_bits_set++;
+
+         // If all lru bits are set to 1 in the set, we make all of them 0
+         if (m_num_bits_set == m_associativity)
+         {
+            m_num_bits_set = 0;
+            for (UInt32 i = 0; i < m_associativity; i++)
+               m_lru_bits[i] = 0;
+         }
+      }
 
    private:
       UInt8* m_lru_bits;
       UInt8  m_num_bits_set;
       UInt8  m_replacement_pointer;
+
+   protected:
+      void saveReplacementState(std::ostream &os) const;
+      void loadReplacementState(std::istream &is);
 };
 
 #endif /* CACHE_SET_NRU_H */
@@ -1,17 +1,25 @@
 #include "cache_set_plru.h"
 #include "log.h"
+#include "checkpoint_manager.h"
 
 // Tree LRU for 4 and 8 way caches
 
+// Tree nodes touched (mask) and their new values (value) when accessing each way
+static const UInt8 plru4_mask[4]  = { 0x03, 0x03, 0x05, 0x05 };
+static const UInt8 plru4_value[4] = { 0x03, 0x01, 0x04, 0x00 };
+static const UInt8 plru8_mask[8]  = { 0x07, 0x07, 0x0b, 0x0b, 0x31, 0x31, 0x51, 0x51 };
+static const UInt8 plru8_value[8] = { 0x07, 0x03, 0x09, 0x01, 0x30, 0x10, 0x40, 0x00 };
+
 CacheSetPLRU::CacheSetPLRU(
       CacheBase::cache_t cache_type,
       UInt32 associativity, UInt32 blocksize) :
-   CacheSet(cache_type, associativity, blocksize)
+   CacheSet(cache_type, associativity, blocksize),
+   m_bits(0)
 {
    LOG_ASSERT_ERROR(associativity == 4 || associativity == 8,
       "PLRU not implemted for associativity %d (only 4, 8)", associativity);
-   for(int i = 0; i < 8; ++i)
-      b[i] = 0;
+   m_update_mask = associativity == 4 ? plru4_mask : plru8_mask;
+   m_update_value = associativity == 4 ? plru4_value : plru8_value;
 }
 
 CacheSetPLRU::~CacheSetPLRU()
@@ -35,42 +43,42 @@ CacheSetPLRU::getReplacementIndex(CacheCntlr *cntlr)
    UInt32 retValue = -1;
    if (m_associativity == 4)
    {
-      if (b[0] == 0)
+      if (b(0) == 0)
       {
-         if (b[1] == 0) retValue = 0;
+         if (b(1) == 0) retValue = 0;
          else           retValue = 1;   // b1==1
       }
       else
       {
-         if (b[2] == 0) retValue = 2;
+         if (b(2) == 0) retValue = 2;
          else           retValue = 3;   // b2==1
       }
    }
    else if (m_associativity == 8)
    {
-      if (b[0] == 0)
+      if (b(0) == 0)
       {
-         if (b[1] == 0)
+         if (b(1) == 0)
          {
-            if (b[2] == 0) retValue= 0;
+            if (b(2) == 0) retValue= 0;
             else           retValue= 1;  // b2==1
          }
          else
          {                            // b1==1
-            if (b[3] == 0) retValue = 2;
+            if (b(3) == 0) retValue = 2;
             else           retValue = 3;  // b3==1
          }
       }
       else
       {                               // b0==1
-         if (b[4] == 0)
+         if (b(4) == 0)
          {
-            if (b[5] == 0) retValue = 4;
+            if (b(5) == 0) retValue = 4;
             else           retValue = 5;  // b5==1
          }
          else
          {                            // b4==1
-            if (b[6] == 0) retValue = 6;
+            if (b(6) == 0) retValue = 6;
             else           retValue = 7;  // b6==1
          }
       }
@@ -88,28 +96,13 @@ CacheSetPLRU::getReplacementIndex(CacheCntlr *cntlr)
 }
 
 void
-CacheSetPLRU::updateReplacementIndex(UInt32 accessed_index)
+CacheSetPLRU::saveReplacementState(std::ostream &os) const
 {
-   if (m_associativity == 4)
-   {
-      if      (accessed_index==0) { b[0]=1;b[1]=1;     }
-      else if (accessed_index==1) { b[0]=1;b[1]=0;     }
-      else if (accessed_index==2) { b[0]=0;       b[2]=1;}
-      else if (accessed_index==3) { b[0]=0;       b[2]=0;}
-   }
-   else if (m_associativity == 8)
-   {
-      if      (accessed_index==0) { b[0]=1;b[1]=1;b[2]=1;                            }
-      else if (accessed_index==1) { b[0]=1;b[1]=1;b[2]=0;                            }
-      else if (accessed_index==2) { b[0]=1;b[1]=0;       b[3]=1;                     }
-      else if (accessed_index==3) { b[0]=1;b[1]=0;       b[3]=0;                     }
-      else if (accessed_index==4) { b[0]=0;                     b[4]=1;b[5]=1;       }
-      else if (accessed_index==5) { b[0]=0;                     b[4]=1;b[5]=0;       }
-      else if (accessed_index==6) { b[0]=0;                     b[4]=0;       b[6]=1;}
-      else if (accessed_index==7) { b[0]=0;                     b[4]=0;       b[6]=0;}
-   }
-   else
-   {
-      LOG_PRINT_ERROR("PLRU doesn't support associativity %d", m_associativity);
-   }
+   CheckpointManager::write(os, m_bits);
+}
+
+void
+CacheSetPLRU::loadReplacementState(std::istream &is)
+{
+   m_bits = CheckpointManager::read<UInt8>(is);
 }
@@ -3,7 +3,7 @@
 
 #include "cache_set.h"
 
-class CacheSetPLRU : public CacheSet
+class CacheSetPLRU final : public CacheSet
 {
    public:
       CacheSetPLRU(CacheBase::cache_t cache_type,
@@ -11,10 +11,23 @@ class CacheSetPLRU : public CacheSet
       ~CacheSetPLRU();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
-      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndex(UInt32 accessed_index)
+      {
+         // Point all tree nodes on the path to accessed_index away from it
+         m_bits = (m_bits & ~m_update_mask[accessed_index]) | m_update_value[accessed_index];
+      }
 
    private:
-      UInt8 b[8];
+      // Tree nodes in pre-order, one bit each: 0 = next victim is in the left subtree, 1 = in the right subtree
+      UInt8 m_bits;
+      const UInt8* m_update_mask;
+      const UInt8* m_update_value;
+
+      bool b(UInt32 node) const { return m_bits & (1 << node); }
+
+   protected:
+      void saveReplacementState(std::ostream &os) const;
+      void loadReplacementState(std::istream &is);
 };
 
 #endif /* CACHE_SET_PLRU_H */
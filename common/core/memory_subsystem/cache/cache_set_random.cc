@@ -39,8 +39,3 @@ CacheSetRandom::getReplacementIndex(CacheCntlr *cntlr)
       return getReplacementIndex(cntlr);
    }
 }
-
-void
-CacheSetRandom::updateReplacementIndex(UInt32 accessed_index)
-{
-}
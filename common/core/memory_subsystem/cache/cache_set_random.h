@@ -3,7 +3,7 @@
 
 #include "cache_set.h"
 
-class CacheSetRandom : public CacheSet
+class CacheSetRandom final : public CacheSet
 {
    public:
       CacheSetRandom(CacheBase::cache_t cache_type,
@@ -11,7 +11,7 @@ class CacheSetRandom : public CacheSet
       ~CacheSetRandom();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
-      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndex(UInt32 accessed_index) {}
 
    private:
       Random m_rand;
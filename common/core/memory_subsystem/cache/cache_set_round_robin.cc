@@ -1,4 +1,5 @@
 #include "cache_set_round_robin.h"
+#include "checkpoint_manager.h"
 
 CacheSetRoundRobin::CacheSetRoundRobin(
       CacheBase::cache_t cache_type,
@@ -24,7 +25,13 @@ CacheSetRoundRobin::getReplacementIndex(CacheCntlr *cntlr)
 }
 
 void
-CacheSetRoundRobin::updateReplacementIndex(UInt32 accessed_index)
+CacheSetRoundRobin::saveReplacementState(std::ostream &os) const
 {
-   return;
+   CheckpointManager::write(os, m_replacement_index);
+}
+
+void
+CacheSetRoundRobin::loadReplacementState(std::istream &is)
+{
+   m_replacement_index = CheckpointManager::read<UInt32>(is);
 }
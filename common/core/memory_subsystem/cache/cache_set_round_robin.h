@@ -3,7 +3,7 @@
 
 #include "cache_set.h"
 
-class CacheSetRoundRobin : public CacheSet
+class CacheSetRoundRobin final : public CacheSet
 {
    public:
       CacheSetRoundRobin(CacheBase::cache_t cache_type,
@@ -11,10 +11,14 @@ class CacheSetRoundRobin : public CacheSet
       ~CacheSetRoundRobin();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
-      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndex(UInt32 accessed_index) {}
 
    private:
       UInt32 m_replacement_index;
+
+   protected:
+      void saveReplacementState(std::ostream &os) const;
+      void loadReplacementState(std::istream &is);
 };
 
 #endif /* CACHE_SET_ROUND_ROBIN_H */
@@ -2,6 +2,7 @@
 #include "simulator.h"
 #include "config.hpp"
 #include "log.h"
+#include "checkpoint_manager.h"
 
 // S-RRIP: Static Re-reference Interval Prediction policy
 
@@ -96,10 +97,15 @@ CacheSetSRRIP::getReplacementIndex(CacheCntlr *cntlr)
 }
 
 void
-CacheSetSRRIP::updateReplacementIndex(UInt32 accessed_index)
+CacheSetSRRIP::saveReplacementState(std::ostream &os) const
 {
-   m_set_info->increment(m_rrip_bits[accessed_index]);
+   os.write((const char*)m_rrip_bits, m_associativity);
+   CheckpointManager::write(os, m_replacement_pointer);
+}
 
-   if (m_rrip_bits[accessed_index] > 0)
-      m_rrip_bits[accessed_index]--;
+void
+CacheSetSRRIP::loadReplacementState(std::istream &is)
+{
+   is.read((char*)m_rrip_bits, m_associativity);
+   m_replacement_pointer = CheckpointManager::read<UInt8>(is);
 }
@@ -4,7 +4,7 @@
 #include "cache_set.h"
 #include "cache_set_lru.h"
 
-class CacheSetSRRIP : public CacheSet
+class CacheSetSRRIP final : public CacheSet
 {
    public:
       CacheSetSRRIP(String cfgname, core_id_t core_id,
@@ -13,7 +13,13 @@ class CacheSetSRRIP : public CacheSet
       ~CacheSetSRRIP();
 
       UInt32 getReplacementIndex(CacheCntlr *cntlr);
-      void updateReplacementIndex(UInt32 accessed_index);
+      void updateReplacementIndex(UInt32 accessed_index)
+      {
+         m_set_info->increment(m_rrip_bits[accessed_index]);
+
+         if (m_rrip_bits[accessed_index] > 0)
+            m_rrip_bits[accessed_index]--;
+      }
 
    private:
       const UInt8 m_rrip_numbits;
@@ -23,6 +29,10 @@ class CacheSetSRRIP : public CacheSet
       UInt8* m_rrip_bits;
       UInt8  m_replacement_pointer;
       CacheSetInfoLRU* m_set_info;
+
+   protected:
+      void saveReplacementState(std::ostream &os) const;
+      void loadReplacementState(std::istream &is);
 };
 
 #endif /* CACHE_SET_H */
@@ -1,5 +1,6 @@
 #include "pr_l2_cache_block_info.h"
 #include "log.h"
+#include "checkpoint_manager.h"
 
 MemComponent::component_t 
 PrL2CacheBlockInfo::getCachedLoc()
@@ -60,3 +61,17 @@ PrL2CacheBlockInfo::clone(CacheBlockInfo* cache_block_info)
    m_cached_loc_bitvec = ((PrL2CacheBlockInfo*) cache_block_info)->getCachedLocBitVec();
    CacheBlockInfo::clone(cache_block_info);
 }
+
+void
+PrL2CacheBlockInfo::saveState(std::ostream &os) const
+{
+   CheckpointManager::write(os, m_cached_loc_bitvec);
+   CacheBlockInfo::saveState(os);
+}
+
+void
+PrL2CacheBlockInfo::loadState(std::istream &is)
+{
+   m_cached_loc_bitvec = CheckpointManager::read<UInt32>(is);
+   CacheBlockInfo::loadState(is);
+}
@@ -6,6 +6,7 @@
 #include "stats.h"
 #include "log.h"
 #include "config.hpp"
+#include "checkpoint_manager.h"
 
 Directory::Directory(core_id_t core_id, String directory_type_str, UInt32 num_entries, UInt32 max_hw_sharers, UInt32 max_num_sharers):
    m_num_entries(num_entries),
@@ -122,3 +123,45 @@ Directory::createDirectoryEntrySized()
          return NULL;
    }
 }
+
+void
+Directory::saveState(std::ostream &os) const
+{
+   CheckpointManager::write(os, m_num_entries);
+   for (UInt32 i = 0; i < m_num_entries; i++)
+   {
+      DirectoryEntry* directory_entry = m_directory_entry_list[i];
+      CheckpointManager::write<bool>(os, directory_entry != NULL);
+      if (directory_entry == NULL)
+         continue;
+
+      DirectorySharersList sharers_list = directory_entry->getSharersList();
+      CheckpointManager::write(os, directory_entry->getAddress());
+      CheckpointManager::write(os, directory_entry->getDirectoryBlockInfo()->getDState());
+      CheckpointManager::write(os, directory_entry->getOwner());
+      CheckpointManager::write<UInt32>(os, sharers_list.size());
+      for (DirectorySharersList::iterator it = sharers_list.begin(); it != sharers_list.end(); ++it)
+         CheckpointManager::write(os, *it);
+   }
+}
+
+void
+Directory::loadState(std::istream &is)
+{
+   UInt32 num_entries = CheckpointManager::read<UInt32>(is);
+   LOG_ASSERT_ERROR(num_entries == m_num_entries, "Checkpoint has %u directory entries, configured for %u", num_entries, m_num_entries);
+   for (UInt32 i = 0; i < m_num_entries; i++)
+   {
+      if (!CheckpointManager::read<bool>(is))
+         continue;
+
+      DirectoryEntry* directory_entry = getDirectoryEntry(i);
+      directory_entry->setAddress(CheckpointManager::read<IntPtr>(is));
+      directory_entry->getDirectoryBlockInfo()->setDState(CheckpointManager::read<DirectoryState::dstate_t>(is));
+      core_id_t owner = CheckpointManager::read<core_id_t>(is);
+      UInt32 num_sharers = CheckpointManager::read<UInt32>(is);
+      for (UInt32 j = 0; j < num_sharers; j++)
+         directory_entry->addSharer(CheckpointManager::read<core_id_t>(is), m_use_max_hw_sharers);
+      directory_entry->setOwner(owner);
+   }
+}
@@ -5,6 +5,8 @@
 #include "fixed_types.h"
 #include "subsecond_time.h"
 
+#include <iostream>
+
 class Directory
 {
    public:
@@ -40,6 +42,9 @@ class Directory
 
       UInt32 getMaxHwSharers() const { return m_use_max_hw_sharers; }
 
+      void saveState(std::ostream &os) const;
+      void loadState(std::istream &is);
+
       static DirectoryType parseDirectoryType(String directory_type_str);
 };
 
@@ -5,32 +5,115 @@
 #include "directory_block_info.h"
 #include "subsecond_time.h"
 
-#include <vector>
-#include <bitset>
 #include <cassert>
 
+// Sharer sets are bitmaps stored as an array of 64-bit words, so they can be counted
+// with popcount and walked one set bit at a time without building a list of core ids
+
 template <long Size>
-class DirectorySharersBitset : public std::bitset<Size>
+class DirectorySharersBitset
 {
+   private:
+      UInt64 m_words[(Size + 63) / 64];
+
    public:
-      DirectorySharersBitset(UInt32 max_num_sharers) : std::bitset<Size>()
-      { assert(max_num_sharers <= Size); }
+      DirectorySharersBitset(UInt32 max_num_sharers)
+      {
+         assert(max_num_sharers <= Size);
+         for(UInt32 i = 0; i < numWords(); ++i)
+            m_words[i] = 0;
+      }
+      UInt32 size() const { return Size; }
+      UInt32 numWords() const { return (Size + 63) / 64; }
+      const UInt64* words() const { return m_words; }
+      bool test(UInt32 index) const { return m_words[index / 64] & (1ull << (index % 64)); }
+      void set(UInt32 index) { m_words[index / 64] |= 1ull << (index % 64); }
+      void reset(UInt32 index) { m_words[index / 64] &= ~(1ull << (index % 64)); }
 };
 
-class DirectorySharersVector : public std::vector<bool>
+// For configurations beyond the largest fixed size: the words are allocated once, when the entry is created
+class DirectorySharersVector
 {
+   private:
+      const UInt32 m_size;
+      UInt64* m_words;
+
+      DirectorySharersVector(const DirectorySharersVector&);
+      DirectorySharersVector& operator=(const DirectorySharersVector&);
+
    public:
-      DirectorySharersVector(UInt32 max_num_sharers) : std::vector<bool>(max_num_sharers, false) {}
-      UInt32 count(void) const
+      DirectorySharersVector(UInt32 max_num_sharers)
+         : m_size(max_num_sharers)
+         , m_words(new UInt64[numWords()])
       {
-         UInt32 num_sharers = 0;
-         for(UInt32 j = 0; j < this->size(); ++j) {
-            if ((*this)[j]) {
-               num_sharers ++;
+         for(UInt32 i = 0; i < numWords(); ++i)
+            m_words[i] = 0;
+      }
+      ~DirectorySharersVector() { delete [] m_words; }
+      UInt32 size() const { return m_size; }
+      UInt32 numWords() const { return (m_size + 63) / 64; }
+      const UInt64* words() const { return m_words; }
+      bool test(UInt32 index) const { return m_words[index / 64] & (1ull << (index % 64)); }
+      void set(UInt32 index) { m_words[index / 64] |= 1ull << (index % 64); }
+      void reset(UInt32 index) { m_words[index / 64] &= ~(1ull << (index % 64)); }
+};
+
+// Read-only view of the sharers of a directory entry.
+// Only valid as long as the entry is not modified.
+class DirectorySharersList
+{
+   private:
+      bool m_broadcast;
+      const UInt64* m_words;
+      UInt32 m_num_words;
+
+   public:
+      class iterator
+      {
+         private:
+            const UInt64* m_words;
+            UInt32 m_num_words;
+            UInt32 m_word;
+            UInt64 m_bits; // Bits of m_words[m_word] not yet visited
+
+            void skipEmpty()
+            {
+               while (m_bits == 0 && m_word + 1 < m_num_words)
+                  m_bits = m_words[++m_word];
+               if (m_bits == 0)
+                  m_word = m_num_words; // end()
             }
-         }
+
+         public:
+            iterator(const UInt64* words, UInt32 num_words, UInt32 word)
+               : m_words(words), m_num_words(num_words), m_word(word), m_bits(word < num_words ? words[word] : 0)
+            { skipEmpty(); }
+
+            core_id_t operator*() const { return m_word * 64 + __builtin_ctzll(m_bits); }
+            iterator& operator++() { m_bits &= m_bits - 1; skipEmpty(); return *this; }
+            bool operator==(const iterator& other) const { return m_word == other.m_word && m_bits == other.m_bits; }
+            bool operator!=(const iterator& other) const { return !(*this == other); }
+      };
+
+      DirectorySharersList(bool broadcast, const UInt64* words, UInt32 num_words)
+         : m_broadcast(broadcast), m_words(words), m_num_words(num_words)
+      {}
+
+      // True when the exact sharers are not known, and invalidations need to be broadcast
+      bool isBroadcast() const { return m_broadcast; }
+
+      iterator begin() const { return iterator(m_words, m_num_words, 0); }
+      iterator end() const { return iterator(m_words, m_num_words, m_num_words); }
+
+      UInt32 size() const
+      {
+         UInt32 num_sharers = 0;
+         for(UInt32 i = 0; i < m_num_words; ++i)
+            num_sharers += __builtin_popcountll(m_words[i]);
          return num_sharers;
       }
+      bool empty() const { return begin() == end(); }
+      core_id_t front() const { assert(!empty()); return *begin(); }
 };
 
 class DirectoryEntry
@@ -74,7 +157,7 @@ class DirectoryEntry
       void setAddress(IntPtr address) { m_address = address; }
 
       virtual core_id_t getOneSharer() = 0;
-      virtual std::pair<bool, std::vector<core_id_t> > getSharersList() = 0;
+      virtual DirectorySharersList getSharersList() = 0;
 
       virtual SubsecondTime getLatency() = 0;
 };
@@ -92,24 +175,10 @@ class DirectoryEntrySized : public DirectoryEntry
       {
       }
 
-      virtual UInt32 getNumSharers() { return m_sharers.count(); }
-      virtual std::pair<bool, std::vector<core_id_t> > getSharersList()
+      virtual UInt32 getNumSharers() { return getSharersList().size(); }
+      virtual DirectorySharersList getSharersList()
       {
-         std::pair<bool, std::vector<core_id_t> > sharers_list;
-         sharers_list.first = false;
-         sharers_list.second.resize(getNumSharers());
-
-         SInt32 i = 0;
-         for(UInt32 j = 0; j < m_sharers.size(); ++j) {
-            if (m_sharers[j]) {
-               core_id_t new_sharer = j;
-               sharers_list.second[i] = new_sharer;
-               i++;
-               assert (i <= (core_id_t) m_sharers.size());
-            }
-         }
-
-         return sharers_list;
+         return DirectorySharersList(false, m_sharers.words(), m_sharers.numWords());
       }
 };
 
@@ -57,7 +57,7 @@ template <class DirectorySharers>
 bool
 DirectoryEntryLimitless<DirectorySharers>::hasSharer(core_id_t sharer_id)
 {
-   return this->m_sharers[sharer_id];
+   return this->m_sharers.test(sharer_id);
 }
 
 // Return value says whether the sharer was successfully added
@@ -67,7 +67,7 @@ template <class DirectorySharers>
 bool
 DirectoryEntryLimitless<DirectorySharers>::addSharer(core_id_t sharer_id, UInt32 max_hw_sharers)
 {
-   assert(! this->m_sharers[sharer_id]);
+   assert(! this->m_sharers.test(sharer_id));
 
    // I have to calculate the latency properly here
    if (this->m_sharers.size() == max_hw_sharers)
@@ -75,7 +75,7 @@ DirectoryEntryLimitless<DirectorySharers>::addSharer(core_id_t sharer_id, UInt32
       m_software_trap_enabled = true;
    }
 
-   this->m_sharers[sharer_id] = true;
+   this->m_sharers.set(sharer_id);
    return true;;
 }
 
@@ -85,8 +85,8 @@ DirectoryEntryLimitless<DirectorySharers>::removeSharer(core_id_t sharer_id, boo
 {
    assert(!reply_expected);
 
-   assert(this->m_sharers[sharer_id]);
-   this->m_sharers[sharer_id] = false;
+   assert(this->m_sharers.test(sharer_id));
+   this->m_sharers.reset(sharer_id);
 }
 
 template <class DirectorySharers>
@@ -101,7 +101,7 @@ void
 DirectoryEntryLimitless<DirectorySharers>::setOwner(core_id_t owner_id)
 {
    if (owner_id != INVALID_CORE_ID)
-      assert(this->m_sharers[owner_id]);
+      assert(this->m_sharers.test(owner_id));
    this->m_owner_id = owner_id;
 }
 
@@ -109,15 +109,7 @@ template <class DirectorySharers>
 core_id_t
 DirectoryEntryLimitless<DirectorySharers>::getOneSharer()
 {
-   core_id_t sharer_id = -1;
-   for(UInt32 j = 0; j < this->m_sharers.size(); ++j) {
-      if (this->m_sharers[j]) {
-         sharer_id = j;
-         break;
-      }
-   }
-   assert(sharer_id != -1);
-   return sharer_id;
+   return this->getSharersList().front();
 }
 
 #endif /* __DIRECTORY_ENTRY_LIMITLESS_H__ */
@@ -9,6 +9,7 @@
 #include "hooks_manager.h"
 #include "cache_atd.h"
 #include "shmem_perf.h"
+#include "clock_skew_minimization_object.h"
 
 #include <cstring>
 
@@ -94,6 +95,17 @@ CacheMasterCntlr::getSetLock(IntPtr addr)
    return &m_setlocks.at((addr >> m_log_blocksize) & (m_num_sets-1));
 }
 
+void
+CacheMasterCntlr::createSlices(UInt32 cache_block_size, UInt32 num_sets, UInt32 shared_cores)
+{
+   // One slice per sharing core, rounded up to a power of two but not more than there are sets
+   m_num_slices = 1;
+   while (m_num_slices < shared_cores && m_num_slices * 2 <= num_sets)
+      m_num_slices *= 2;
+   m_slice_log_blocksize = floorLog2(cache_block_size);
+   m_slices = new Slice[m_num_slices];
+}
+
 void
 CacheMasterCntlr::createATDs(String name, String configName, core_id_t master_core_id, UInt32 shared_cores, UInt32 size,
    UInt32 associativity, UInt32 block_size, String replacement_policy, CacheBase::hash_t hash_function)
@@ -114,6 +126,7 @@ CacheMasterCntlr::accessATDs(Core::mem_op_t mem_op_type, bool hit, IntPtr addres
 
 CacheMasterCntlr::~CacheMasterCntlr()
 {
+   delete [] m_slices;
    delete m_cache;
    for(std::vector<ATD*>::iterator it = m_atds.begin(); it != m_atds.end(); ++it)
    {
@@ -180,6 +193,7 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
                ? Sim()->getFaultinjectionManager()->getFaultInjector(m_core_id_master, mem_component)
                : NULL);
       m_master->m_prefetcher = Prefetcher::createPrefetcher(cache_params.prefetcher, cache_params.configName, m_core_id, m_shared_cores);
+      m_master->createSlices(m_cache_block_size, cache_params.num_sets, m_shared_cores);
 
       if (Sim()->getCfg()->getBoolDefault("perf_model/" + cache_params.configName + "/atd/enabled", false))
       {
@@ -380,7 +394,7 @@ LOG_ASSERT_ERROR(offset + data_length <= getCacheBlockSize(), "access until %u >
 
    if (count)
    {
-      ScopedLock sl(getLock());
+      ScopedLock sl(getLock(ca_address));
       // Update the Cache Counters
       getCache()->updateCounters(cache_hit);
       updateCounters(mem_op_type, ca_address, cache_hit, getCacheState(cache_block_info), Prefetch::NONE);
@@ -424,13 +438,14 @@ MYLOG("L1 hit");
 
       if (modeled)
       {
-         ScopedLock sl(getLock());
+         ScopedLock sl(getLock(ca_address));
          // This is a hit, but maybe the prefetcher filled it at a future time stamp. If so, delay.
          SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-         if (m_master->mshr.count(ca_address)
-            && (m_master->mshr[ca_address].t_issue < t_now && m_master->mshr[ca_address].t_complete > t_now))
+         Mshr &mshr = getMshr(ca_address);
+         if (mshr.count(ca_address)
+            && (mshr[ca_address].t_issue < t_now && mshr[ca_address].t_complete > t_now))
          {
-            SubsecondTime latency = m_master->mshr[ca_address].t_complete - t_now;
+            SubsecondTime latency = mshr[ca_address].t_complete - t_now;
             stats.mshr_latency += latency;
             getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
          }
@@ -607,7 +622,7 @@ MYLOG("access done");
 void
 CacheCntlr::updateHits(Core::mem_op_t mem_op_type, UInt64 hits)
 {
-   ScopedLock sl(getLock());
+   ScopedLock sl(getLock(0));
 
    while(hits > 0)
    {
@@ -792,7 +807,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
 
    if (count)
    {
-      ScopedLock sl(getLock());
+      ScopedLock sl(getLock(address));
       if (isPrefetch == Prefetch::NONE)
          getCache()->updateCounters(cache_hit);
       updateCounters(mem_op_type, address, cache_hit, getCacheState(address), isPrefetch);
@@ -820,13 +835,14 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
          of the previous-level cache, not our (longer) access time */
       if (modeled)
       {
-         ScopedLock sl(getLock());
+         ScopedLock sl(getLock(address));
          // This is a hit, but maybe the prefetcher filled it at a future time stamp. If so, delay.
          SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-         if (m_master->mshr.count(address)
-            && (m_master->mshr[address].t_issue < t_now && m_master->mshr[address].t_complete > t_now))
+         Mshr &mshr = getMshr(address);
+         if (mshr.count(address)
+            && (mshr[address].t_issue < t_now && mshr[address].t_complete > t_now))
          {
-            SubsecondTime latency = m_master->mshr[address].t_complete - t_now;
+            SubsecondTime latency = mshr[address].t_complete - t_now;
             stats.mshr_latency += latency;
             getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
          }
@@ -1002,9 +1018,9 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
       /* Store completion time so we can detect overlapping accesses */
       if (modeled && !first_hit && !m_passthrough)
       {
-         ScopedLock sl(getLock());
-         m_master->mshr[address] = make_mshr(t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD));
-         cleanupMshr();
+         ScopedLock sl(getLock(address));
+         getMshr(address)[address] = make_mshr(t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD));
+         cleanupMshr(address);
       }
    }
 
@@ -1765,6 +1781,14 @@ CacheCntlr::handleMsgFromDramDirectory(
    acquireStackLock(address);
 MYLOG("begin");
 
+   if ((shmem_msg_type == PrL1PrL2DramDirectoryMSI::ShmemMsg::INV_REQ) || (shmem_msg_type == PrL1PrL2DramDirectoryMSI::ShmemMsg::FLUSH_REQ)
+         || (shmem_msg_type == PrL1PrL2DramDirectoryMSI::ShmemMsg::WB_REQ) )
+   {
+      // Another core's request reached into our caches
+      if (shmem_msg->getRequester() != m_core_id)
+         Sim()->getClockSkewMinimizationServer()->notifyInteraction();
+   }
+
    switch (shmem_msg_type)
    {
       case PrL1PrL2DramDirectoryMSI::ShmemMsg::EX_REP:
@@ -1843,9 +1867,9 @@ MYLOG("wakeup user #%u", request->cache_cntlr->m_core_id);
          acquireStackLock(address);
 
          {
-            ScopedLock sl(request->cache_cntlr->getLock());
-            request->cache_cntlr->m_master->mshr[address] = make_mshr(request->t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_SIM_THREAD));
-            cleanupMshr();
+            ScopedLock sl(getLock(address));
+            getMshr(address)[address] = make_mshr(request->t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_SIM_THREAD));
+            cleanupMshr(address);
          }
 
          getLock().acquire();
@@ -2052,7 +2076,8 @@ CacheCntlr::updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cach
       operationPermissibleinCache() will think it's a hit (so cache_hit == true) since the processing
       of the previous miss was done instantaneously. But mshr[address] contains its completion time */
    SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-   bool overlapping = m_master->mshr.count(address) && m_master->mshr[address].t_issue < t_now && m_master->mshr[address].t_complete > t_now;
+   Mshr &mshr = getMshr(address);
+   bool overlapping = mshr.count(address) && mshr[address].t_issue < t_now && mshr[address].t_complete > t_now;
 
    // ATD doesn't track state, so when reporting hit/miss to it we shouldn't either (i.e. write hit to shared line becomes hit, not miss)
    bool cache_data_hit = (state != CacheState::INVALID);
@@ -2089,7 +2114,7 @@ CacheCntlr::updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cach
       }
    }
 
-   cleanupMshr();
+   cleanupMshr(address);
 
    #ifdef ENABLE_TRANSITIONS
    transition(
@@ -2102,19 +2127,20 @@ CacheCntlr::updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cach
 }
 
 void
-CacheCntlr::cleanupMshr()
+CacheCntlr::cleanupMshr(IntPtr address)
 {
-   /* Keep only last 8 MSHR entries */
-   while(m_master->mshr.size() > 8) {
+   /* Keep only last 8 MSHR entries (per slice) */
+   Mshr &mshr = getMshr(address);
+   while(mshr.size() > 8) {
       IntPtr address_min = 0;
       SubsecondTime time_min = SubsecondTime::MaxTime();
-      for(Mshr::iterator it = m_master->mshr.begin(); it != m_master->mshr.end(); ++it) {
+      for(Mshr::iterator it = mshr.begin(); it != mshr.end(); ++it) {
          if (it->second.t_complete < time_min) {
             address_min = it->first;
             time_min = it->second.t_complete;
          }
       }
-      m_master->mshr.erase(address_min);
+      mshr.erase(address_min);
    }
 }
 
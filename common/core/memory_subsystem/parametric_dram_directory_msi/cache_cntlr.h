@@ -157,7 +157,6 @@ namespace ParametricDramDirectoryMSI
          DramCntlrInterface* m_dram_cntlr;
          ContentionModel* m_dram_outstanding_writebacks;
 
-         Mshr mshr;
          ContentionModel m_l1_mshr;
          ContentionModel m_next_level_read_bandwidth;
          CacheDirectoryWaiterMap m_directory_waiters;
@@ -170,11 +169,24 @@ namespace ParametricDramDirectoryMSI
          UInt32 m_log_blocksize;
          UInt32 m_num_sets;
 
+         // State shared by all cores on this cache that is kept per address, partitioned by set index into
+         // slices with their own lock so cores accessing different slices of a shared cache do not contend
+         struct Slice
+         {
+            Lock lock;
+            Mshr mshr;
+         };
+         Slice* m_slices;
+         UInt32 m_num_slices;
+         UInt32 m_slice_log_blocksize;
+
          std::deque<IntPtr> m_prefetch_list;
          SubsecondTime m_prefetch_next;
 
          void createSetLocks(UInt32 cache_block_size, UInt32 num_sets, UInt32 core_offset, UInt32 num_cores);
          SetLock* getSetLock(IntPtr addr);
+         void createSlices(UInt32 cache_block_size, UInt32 num_sets, UInt32 shared_cores);
+         Slice& getSlice(IntPtr addr) { return m_slices[(addr >> m_slice_log_blocksize) & (m_num_slices - 1)]; }
 
          void createATDs(String name, String configName, core_id_t core_id, UInt32 shared_cores, UInt32 size, UInt32 associativity, UInt32 block_size,
             String replacement_policy, CacheBase::hash_t hash_function);
@@ -190,6 +202,9 @@ namespace ParametricDramDirectoryMSI
             , m_evicting_address(0)
             , m_evicting_buf(NULL)
             , m_atds()
+            , m_slices(NULL)
+            , m_num_slices(0)
+            , m_slice_log_blocksize(0)
             , m_prefetch_list()
             , m_prefetch_next(SubsecondTime::Zero())
          {}
@@ -250,7 +265,7 @@ namespace ParametricDramDirectoryMSI
          #endif
 
          void updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cache_hit, CacheState::cstate_t state, Prefetch::prefetch_type_t isPrefetch);
-         void cleanupMshr();
+         void cleanupMshr(IntPtr address);
          void transition(IntPtr address, Transition::reason_t reason, CacheState::cstate_t old_state, CacheState::cstate_t new_state);
          void updateUncoreStatistics(HitWhere::where_t hit_where, SubsecondTime now);
 
@@ -366,6 +381,8 @@ namespace ParametricDramDirectoryMSI
 
          Cache* getCache() { return m_master->m_cache; }
          Lock& getLock() { return m_master->m_cache_lock; }
+         Lock& getLock(IntPtr address) { return m_master->getSlice(address).lock; }
+         Mshr& getMshr(IntPtr address) { return m_master->getSlice(address).mshr; }
 
          void setPrevCacheCntlrs(CacheCntlrList& prev_cache_cntlrs);
          void setNextCacheCntlr(CacheCntlr* next_cache_cntlr) { m_next_cache_cntlr = next_cache_cntlr; }
@@ -38,6 +38,7 @@ MemoryManager::MemoryManager(Core* core,
    m_dram_directory_cntlr(NULL),
    m_dram_cntlr(NULL),
    m_itlb(NULL), m_dtlb(NULL), m_stlb(NULL),
+   m_page_walk_cache(NULL),
    m_tlb_miss_penalty(NULL,0),
    m_tlb_miss_parallel(false),
    m_tag_directory_present(false),
@@ -71,13 +72,16 @@ MemoryManager::MemoryManager(Core* core,
 
       UInt32 stlb_size = Sim()->getCfg()->getInt("perf_model/stlb/size");
       if (stlb_size)
-         m_stlb = new TLB("stlb", "perf_model/stlb", getCore()->getId(), stlb_size, Sim()->getCfg()->getInt("perf_model/stlb/associativity"), NULL);
+         m_stlb = new TLB("stlb", getCore()->getId(), stlb_size, Sim()->getCfg()->getInt("perf_model/stlb/associativity"), NULL);
       UInt32 itlb_size = Sim()->getCfg()->getInt("perf_model/itlb/size");
       if (itlb_size)
-         m_itlb = new TLB("itlb", "perf_model/itlb", getCore()->getId(), itlb_size, Sim()->getCfg()->getInt("perf_model/itlb/associativity"), m_stlb);
+         m_itlb = new TLB("itlb", getCore()->getId(), itlb_size, Sim()->getCfg()->getInt("perf_model/itlb/associativity"), m_stlb);
       UInt32 dtlb_size = Sim()->getCfg()->getInt("perf_model/dtlb/size");
       if (dtlb_size)
-         m_dtlb = new TLB("dtlb", "perf_model/dtlb", getCore()->getId(), dtlb_size, Sim()->getCfg()->getInt("perf_model/dtlb/associativity"), m_stlb);
+         m_dtlb = new TLB("dtlb", getCore()->getId(), dtlb_size, Sim()->getCfg()->getInt("perf_model/dtlb/associativity"), m_stlb);
+      UInt32 pwc_size = Sim()->getCfg()->getInt("perf_model/tlb/pwc_size");
+      if (pwc_size && (m_itlb || m_dtlb))
+         m_page_walk_cache = new PageWalkCache(getCore()->getId(), TLB::getPageShift(), pwc_size);
       m_tlb_miss_penalty = ComponentLatency(core->getDvfsDomain(), Sim()->getCfg()->getInt("perf_model/tlb/penalty"));
       m_tlb_miss_parallel = Sim()->getCfg()->getBool("perf_model/tlb/penalty_parallel");
 
@@ -386,6 +390,7 @@ MemoryManager::~MemoryManager()
    if (m_itlb) delete m_itlb;
    if (m_dtlb) delete m_dtlb;
    if (m_stlb) delete m_stlb;
+   if (m_page_walk_cache) delete m_page_walk_cache;
 
    for(i = MemComponent::FIRST_LEVEL_CACHE; i <= (UInt32)m_last_level_cache; ++i)
    {
@@ -590,18 +595,25 @@ void
 MemoryManager::accessTLB(TLB * tlb, IntPtr address, bool isIfetch, Core::MemModeled modeled)
 {
    bool hit = tlb->lookup(address, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD));
-   if (hit == false
-       && !(modeled == Core::MEM_MODELED_NONE || modeled == Core::MEM_MODELED_COUNT)
-       && m_tlb_miss_penalty.getLatency() != SubsecondTime::Zero()
+   if (hit)
+      return;
+
+   // The page walk penalty is for a full walk, scale it to the levels not covered by the page-walk cache
+   SubsecondTime penalty = m_tlb_miss_penalty.getLatency();
+   if (m_page_walk_cache)
+      penalty = penalty * m_page_walk_cache->walk(address) / m_page_walk_cache->getNumLevels();
+
+   if (!(modeled == Core::MEM_MODELED_NONE || modeled == Core::MEM_MODELED_COUNT)
+       && penalty != SubsecondTime::Zero()
    )
    {
       if (m_tlb_miss_parallel)
       {
-         incrElapsedTime(m_tlb_miss_penalty.getLatency(), ShmemPerfModel::_USER_THREAD);
+         incrElapsedTime(penalty, ShmemPerfModel::_USER_THREAD);
       }
       else
       {
-         PseudoInstruction *i = new TLBMissInstruction(m_tlb_miss_penalty.getLatency(), isIfetch);
+         PseudoInstruction *i = new TLBMissInstruction(penalty, isIfetch);
          getCore()->getPerformanceModel()->queuePseudoInstruction(i);
       }
    }
@@ -1,13 +1,23 @@
 #include "tlb.h"
+#include "simulator.h"
+#include "config.hpp"
 #include "stats.h"
+#include "utils.h"
+#include "log.h"
+
+#include <algorithm>
 
 namespace ParametricDramDirectoryMSI
 {
 
-TLB::TLB(String name, String cfgname, core_id_t core_id, UInt32 num_entries, UInt32 associativity, TLB *next_level)
-   : m_size(num_entries)
+TLB::TLB(String name, core_id_t core_id, UInt32 num_entries, UInt32 associativity, TLB *next_level)
+   : m_name(name)
+   , m_core_id(core_id)
+   , m_page_shift(getPageShift())
+   , m_num_sets(num_entries / associativity)
    , m_associativity(associativity)
-   , m_cache(name + "_cache", cfgname, core_id, num_entries / associativity, associativity, SIM_PAGE_SIZE, "lru", CacheBase::PR_L1_CACHE)
+   , m_pages(num_entries, INVALID_PAGE)
+   , m_last_page(INVALID_PAGE)
    , m_next_level(next_level)
    , m_access(0)
    , m_miss(0)
@@ -16,44 +26,157 @@ TLB::TLB(String name, String cfgname, core_id_t core_id, UInt32 num_entries, UIn
 
    registerStatsMetric(name, core_id, "access", &m_access);
    registerStatsMetric(name, core_id, "miss", &m_miss);
+
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->registerObject(m_name, m_core_id, this);
 }
 
-bool
-TLB::lookup(IntPtr address, SubsecondTime now, bool allocate_on_miss)
+TLB::~TLB()
+{
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->unregisterObject(m_name, m_core_id);
+}
+
+UInt32
+TLB::getPageShift()
 {
-   bool hit = m_cache.accessSingleLine(address, Cache::LOAD, NULL, 0, now, true);
+   UInt64 page_size = Sim()->getCfg()->getInt("perf_model/tlb/page_size");
+   LOG_ASSERT_ERROR(page_size == (1 << 12) || page_size == (1 << 21) || page_size == (1 << 30),
+                    "Invalid perf_model/tlb/page_size %" PRIu64 ", only 4 KB, 2 MB and 1 GB pages are supported", page_size);
+   return floorLog2(page_size);
+}
 
+bool
+TLB::lookupPage(IntPtr page, bool allocate_on_miss)
+{
    m_access++;
 
-   if (hit)
-      return true;
+   IntPtr *set = &m_pages[(page % m_num_sets) * m_associativity];
+   for (UInt32 way = 0; way < m_associativity; way++)
+   {
+      if (set[way] == page)
+      {
+         // Move to the most recently used position
+         std::copy_backward(set, set + way, set + way + 1);
+         set[0] = page;
+         m_last_page = page;
+         return true;
+      }
+   }
 
    m_miss++;
 
+   bool hit = false;
    if (m_next_level)
    {
-      hit = m_next_level->lookup(address, now, false /* no allocation */);
+      hit = m_next_level->lookupPage(page, false /* no allocation */);
    }
 
    if (allocate_on_miss)
    {
-      allocate(address, now);
+      allocatePage(page);
    }
 
    return hit;
 }
 
 void
-TLB::allocate(IntPtr address, SubsecondTime now)
+TLB::allocatePage(IntPtr page)
 {
-   bool eviction;
-   IntPtr evict_addr;
-   CacheBlockInfo evict_block_info;
-   m_cache.insertSingleLine(address, NULL, &eviction, &evict_addr, &evict_block_info, NULL, now);
+   IntPtr *set = &m_pages[(page % m_num_sets) * m_associativity];
+
+   // Evict the least recently used entry, unless the page is already present (when used as a victim cache)
+   UInt32 way = std::find(set, set + m_associativity, page) - set;
+   IntPtr evict_page = INVALID_PAGE;
+   if (way == m_associativity)
+   {
+      way = m_associativity - 1;
+      evict_page = set[way];
+   }
+
+   std::copy_backward(set, set + way, set + way + 1);
+   set[0] = page;
+   m_last_page = page;
 
    // Use next level as a victim cache
-   if (eviction && m_next_level)
-      m_next_level->allocate(evict_addr, now);
+   if (evict_page != INVALID_PAGE && m_next_level)
+      m_next_level->allocatePage(evict_page);
+}
+
+void
+TLB::saveCheckpoint(std::ostream &os)
+{
+   CheckpointManager::write(os, m_page_shift);
+   CheckpointManager::write(os, m_num_sets);
+   CheckpointManager::write(os, m_associativity);
+   for (std::vector<IntPtr>::const_iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+      CheckpointManager::write(os, *it);
+}
+
+void
+TLB::loadCheckpoint(std::istream &is)
+{
+   UInt32 page_shift = CheckpointManager::read<UInt32>(is);
+   UInt32 num_sets = CheckpointManager::read<UInt32>(is);
+   UInt32 associativity = CheckpointManager::read<UInt32>(is);
+   LOG_ASSERT_ERROR(page_shift == m_page_shift && num_sets == m_num_sets && associativity == m_associativity,
+                    "TLB %s: checkpoint has %u sets of %u ways for %u-bit pages, configured for %u sets of %u ways for %u-bit pages",
+                    m_name.c_str(), num_sets, associativity, page_shift, m_num_sets, m_associativity, m_page_shift);
+   for (std::vector<IntPtr>::iterator it = m_pages.begin(); it != m_pages.end(); ++it)
+      *it = CheckpointManager::read<IntPtr>(is);
+   m_last_page = INVALID_PAGE;
+}
+
+
+PageWalkCache::PageWalkCache(core_id_t core_id, UInt32 page_shift, UInt32 size)
+   : m_num_levels(4 - (page_shift - 12) / LEVEL_BITS)
+   , m_size(size)
+   , m_entries(m_num_levels - 1)
+   , m_walks(0)
+   , m_levels_walked(0)
+{
+   registerStatsMetric("page_walk_cache", core_id, "walks", &m_walks);
+   registerStatsMetric("page_walk_cache", core_id, "levels-walked", &m_levels_walked);
+}
+
+IntPtr
+PageWalkCache::getPrefix(IntPtr address, UInt32 level) const
+{
+   // Address bits that select the entry at this level (0 is the root) and all levels above it
+   return address >> (12 + LEVEL_BITS * (3 - level));
+}
+
+UInt32
+PageWalkCache::walk(IntPtr address)
+{
+   // Start the walk below the deepest cached entry
+   UInt32 start = 0;
+   for (UInt32 level = m_entries.size(); level > 0; level--)
+   {
+      std::vector<IntPtr> &entries = m_entries[level - 1];
+      if (std::find(entries.begin(), entries.end(), getPrefix(address, level - 1)) != entries.end())
+      {
+         start = level;
+         break;
+      }
+   }
+
+   // All non-leaf entries on the path become most recently used
+   for (UInt32 level = 0; level < m_entries.size(); level++)
+   {
+      std::vector<IntPtr> &entries = m_entries[level];
+      IntPtr prefix = getPrefix(address, level);
+      std::vector<IntPtr>::iterator it = std::find(entries.begin(), entries.end(), prefix);
+      if (it != entries.end())
+         entries.erase(it);
+      else if (entries.size() == m_size)
+         entries.pop_back();
+      entries.insert(entries.begin(), prefix);
+   }
+
+   ++m_walks;
+   m_levels_walked += m_num_levels - start;
+   return m_num_levels - start;
 }
 
 }
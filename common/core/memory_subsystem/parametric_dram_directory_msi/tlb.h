@@ -2,28 +2,77 @@
 #define TLB_H
 
 #include "fixed_types.h"
-#include "cache.h"
+#include "subsecond_time.h"
+#include "checkpoint_manager.h"
+
+#include <vector>
 
 namespace ParametricDramDirectoryMSI
 {
-   class TLB
+   // Set-associative TLB with LRU replacement. Each set keeps its page numbers ordered from most to least
+   // recently used. The page of the last lookup or allocation is always the most recently used entry of its set,
+   // so repeated lookups to the same page are answered by a single compare without touching the sets.
+   class TLB : public Checkpointable
    {
       private:
-         static const UInt32 SIM_PAGE_SHIFT = 12; // 4KB
-         static const IntPtr SIM_PAGE_SIZE = (1L << SIM_PAGE_SHIFT);
-         static const IntPtr SIM_PAGE_MASK = ~(SIM_PAGE_SIZE - 1);
+         static const IntPtr INVALID_PAGE = ~(IntPtr)0;
 
-         UInt32 m_size;
+         String m_name;
+         core_id_t m_core_id;
+         UInt32 m_page_shift;
+         UInt32 m_num_sets;
          UInt32 m_associativity;
-         Cache m_cache;
+         std::vector<IntPtr> m_pages; // m_associativity entries per set, most recently used first
+         IntPtr m_last_page;
 
          TLB *m_next_level;
 
          UInt64 m_access, m_miss;
+
+         bool lookupPage(IntPtr page, bool allocate_on_miss);
+         void allocatePage(IntPtr page);
+      public:
+         TLB(String name, core_id_t core_id, UInt32 num_entries, UInt32 associativity, TLB *next_level);
+         ~TLB();
+
+         bool lookup(IntPtr address, SubsecondTime now, bool allocate_on_miss = true)
+         {
+            IntPtr page = address >> m_page_shift;
+            if (page == m_last_page)
+            {
+               m_access++;
+               return true;
+            }
+            return lookupPage(page, allocate_on_miss);
+         }
+         void allocate(IntPtr address, SubsecondTime now) { allocatePage(address >> m_page_shift); }
+
+         static UInt32 getPageShift();
+
+         void saveCheckpoint(std::ostream &os);
+         void loadCheckpoint(std::istream &is);
+   };
+
+   // Caches the non-leaf entries of a four-level radix page table, so a page walk after a TLB miss
+   // only has to access the levels below the deepest cached entry
+   class PageWalkCache
+   {
+      private:
+         static const UInt32 LEVEL_BITS = 9; // Page-table index bits per level
+
+         UInt32 m_num_levels; // Levels of a full walk, fewer for huge pages
+         UInt32 m_size;       // Entries per level
+         std::vector<std::vector<IntPtr> > m_entries; // Per non-leaf level, most recently used first
+
+         UInt64 m_walks, m_levels_walked;
+
+         IntPtr getPrefix(IntPtr address, UInt32 level) const;
       public:
-         TLB(String name, String cfgname, core_id_t core_id, UInt32 num_entries, UInt32 associativity, TLB *next_level);
-         bool lookup(IntPtr address, SubsecondTime now, bool allocate_on_miss = true);
-         void allocate(IntPtr address, SubsecondTime now);
+         PageWalkCache(core_id_t core_id, UInt32 page_shift, UInt32 size);
+
+         UInt32 getNumLevels() const { return m_num_levels; }
+         // Returns the number of page-table levels accessed to translate address
+         UInt32 walk(IntPtr address);
    };
 }
 
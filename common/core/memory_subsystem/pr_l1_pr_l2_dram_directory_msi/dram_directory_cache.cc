@@ -1,6 +1,7 @@
 #include "dram_directory_cache.h"
 #include "log.h"
 #include "utils.h"
+#include "simulator.h"
 
 namespace PrL1PrL2DramDirectoryMSI
 {
@@ -15,6 +16,7 @@ DramDirectoryCache::DramDirectoryCache(
       UInt32 max_num_sharers,
       ComponentLatency dram_directory_cache_access_time,
       ShmemPerfModel* shmem_perf_model):
+   m_core_id(core_id),
    m_total_entries(total_entries),
    m_associativity(associativity),
    m_cache_block_size(cache_block_size),
@@ -30,10 +32,16 @@ DramDirectoryCache::DramDirectoryCache(
    // Logs
    m_log_num_sets = floorLog2(m_num_sets);
    m_log_cache_block_size = floorLog2(m_cache_block_size);
+
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->registerObject("dram-directory", m_core_id, this);
 }
 
 DramDirectoryCache::~DramDirectoryCache()
 {
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->unregisterObject("dram-directory", m_core_id);
+
    delete m_replacement_ptrs;
    delete m_directory;
 }
@@ -162,4 +170,18 @@ DramDirectoryCache::splitAddress(IntPtr address, IntPtr& tag, UInt32& set_index)
 
 }
 
+void
+DramDirectoryCache::saveCheckpoint(std::ostream &os)
+{
+   os.write((const char*)m_replacement_ptrs, m_num_sets * sizeof(UInt32));
+   m_directory->saveState(os);
+}
+
+void
+DramDirectoryCache::loadCheckpoint(std::istream &is)
+{
+   is.read((char*)m_replacement_ptrs, m_num_sets * sizeof(UInt32));
+   m_directory->loadState(is);
+}
+
 }
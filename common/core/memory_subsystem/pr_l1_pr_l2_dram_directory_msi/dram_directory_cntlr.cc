@@ -343,8 +343,8 @@ DramDirectoryCntlr::processNullifyReq(ShmemReq* shmem_req)
       case DirectoryState::SHARED:
 
          {
-            std::pair<bool, std::vector<SInt32> > sharers_list_pair = directory_entry->getSharersList();
-            if (sharers_list_pair.first == true)
+            DirectorySharersList sharers_list = directory_entry->getSharersList();
+            if (sharers_list.isBroadcast())
             {
                // Broadcast Invalidation Request to all cores
                // (irrespective of whether they are sharers or not)
@@ -359,12 +359,12 @@ DramDirectoryCntlr::processNullifyReq(ShmemReq* shmem_req)
             else
             {
                // Send Invalidation Request to only a specific set of sharers
-               for (UInt32 i = 0; i < sharers_list_pair.second.size(); i++)
+               for (DirectorySharersList::iterator it = sharers_list.begin(); it != sharers_list.end(); ++it)
                {
                   getMemoryManager()->sendMsg(ShmemMsg::INV_REQ,
                         MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                         requester /* requester */,
-                        sharers_list_pair.second[i] /* receiver */,
+                        *it /* receiver */,
                         address,
                         NULL, 0,
                         HitWhere::UNKNOWN,
@@ -433,8 +433,8 @@ DramDirectoryCntlr::processExReqFromL2Cache(ShmemReq* shmem_req, Byte* cached_da
       case DirectoryState::SHARED:
       {
          assert(cached_data_buf == NULL);
-         std::pair<bool, std::vector<SInt32> > sharers_list_pair = directory_entry->getSharersList();
-         if (sharers_list_pair.first == true)
+         DirectorySharersList sharers_list = directory_entry->getSharersList();
+         if (sharers_list.isBroadcast())
          {
             // Broadcast Invalidation Request to all cores
             // (irrespective of whether they are sharers or not)
@@ -449,17 +449,17 @@ DramDirectoryCntlr::processExReqFromL2Cache(ShmemReq* shmem_req, Byte* cached_da
          else
          {
             // Send Invalidation Request to only a specific set of sharers
-            for (UInt32 i = 0; i < sharers_list_pair.second.size(); i++)
+            for (DirectorySharersList::iterator it = sharers_list.begin(); it != sharers_list.end(); ++it)
             {
-               MYLOG("Send INV_REQ>%d for %lx", sharers_list_pair.second[i], address )
+               MYLOG("Send INV_REQ>%d for %lx", *it, address )
                         getMemoryManager()->sendMsg(ShmemMsg::INV_REQ,
                               MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                               requester /* requester */,
-                              sharers_list_pair.second[i] /* receiver */,
+                              *it /* receiver */,
                               address,
                               NULL, 0,
                               HitWhere::UNKNOWN,
-                              i == 0 ? shmem_req->getShmemMsg()->getPerf() : &m_dummy_shmem_perf,
+                              it == sharers_list.begin() ? shmem_req->getShmemMsg()->getPerf() : &m_dummy_shmem_perf,
                               ShmemPerfModel::_SIM_THREAD);
             }
          }
@@ -916,17 +916,17 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
 
    DirectoryBlockInfo* directory_block_info = directory_entry->getDirectoryBlockInfo();
 
-   std::pair<bool, std::vector<SInt32> > sharers_list_pair = directory_entry->getSharersList();
+   DirectorySharersList sharers_list = directory_entry->getSharersList();
 
    DirectoryState::dstate_t curr_dstate = directory_block_info->getDState();
 
    MYLOG("state=%d :: ", curr_dstate);
    MYLOG("owner=%d" , directory_entry->getOwner());
-   if (!sharers_list_pair.first)
+   if (!sharers_list.isBroadcast())
    {
-      for (UInt32 i = 0; i < sharers_list_pair.second.size(); i++)
+      for (DirectorySharersList::iterator it = sharers_list.begin(); it != sharers_list.end(); ++it)
       {
-         MYLOG("sharer: %d",sharers_list_pair.second[i]);
+         MYLOG("sharer: %d", *it);
       }
    }
 
@@ -937,7 +937,7 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
       case DirectoryState::EXCLUSIVE:
       case DirectoryState::MODIFIED:
       {
-         if (sharers_list_pair.second[0] == requester)
+         if (sharers_list.front() == requester)
          {
             MYLOG("upgrade request immediately finished, sending UPGRADE_REP to %d", requester);
             assert (directory_entry->getOwner() == requester);
@@ -957,7 +957,7 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
          else
          {
             // Send FLUSH_REQ to the current owner
-            MYLOG("FLUSH REQ (UPGR)>%u @ %lx",sharers_list_pair.second[0] , address);
+            MYLOG("FLUSH REQ (UPGR)>%u @ %lx",sharers_list.front() , address);
             getMemoryManager()->sendMsg(ShmemMsg::FLUSH_REQ,
                   MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                   requester /* requester */,
@@ -971,7 +971,7 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
       }
       case DirectoryState::SHARED:
       {
-         if ((sharers_list_pair.second.size() == 1) && (sharers_list_pair.second[0] == requester))
+         if ((sharers_list.size() == 1) && (sharers_list.front() == requester))
          {
             // Let the requester know it can take ownership
             MYLOG("sending UPGRADE_REP>%d", requester )
@@ -993,11 +993,11 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
             bool requesterHasCopy = directory_entry->hasSharer(requester);
             if (!requesterHasCopy)
             {
-               MYLOG("UPGRADE_REQ: %lu sharer(s), but the requester isn't holding a copy!?", sharers_list_pair.second.size());
+               MYLOG("UPGRADE_REQ: %lu sharer(s), but the requester isn't holding a copy!?", sharers_list.size());
             }
 
             // send inv_req to all sharers
-            if (sharers_list_pair.first == true)
+            if (sharers_list.isBroadcast())
             {
                // Broadcast Invalidation Request to all cores
                // (irrespective of whether they are sharers or not)
@@ -1013,18 +1013,18 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
             {
                bool shmem_perf_sent = false;
                // Send Invalidation Request to only a specific set of sharers
-               for (UInt32 i = 0; i < sharers_list_pair.second.size(); i++)
+               for (DirectorySharersList::iterator it = sharers_list.begin(); it != sharers_list.end(); ++it)
                {
-                  if (sharers_list_pair.second[i] != requester)
+                  if (*it != requester)
                   {
-                     MYLOG("INV REQ (UPGR)>%u @ %lx",sharers_list_pair.second[i] , shmem_msg->getAddress());
+                     MYLOG("INV REQ (UPGR)>%u @ %lx", *it, shmem_msg->getAddress());
                      // avoid having to fetch the data from DRAM, so ask at least one core to FLUSH instead of INV
-                     ShmemMsg::msg_t msg_type = (!requesterHasCopy && i==0) ? ShmemMsg::FLUSH_REQ : ShmemMsg::INV_REQ;
+                     ShmemMsg::msg_t msg_type = (!requesterHasCopy && it == sharers_list.begin()) ? ShmemMsg::FLUSH_REQ : ShmemMsg::INV_REQ;
                      //ShmemMsg::msg_t msg_type = ShmemMsg::INV_REQ;
                      getMemoryManager()->sendMsg( msg_type, //ShmemMsg::INV_REQ,
                            MemComponent::TAG_DIR, MemComponent::L2_CACHE,
                            requester /* requester */,
-                           sharers_list_pair.second[i] /* receiver */,
+                           *it /* receiver */,
                            address,
                            NULL, 0,
                            HitWhere::UNKNOWN,
@@ -1040,7 +1040,7 @@ DramDirectoryCntlr::processUpgradeReqFromL2Cache(ShmemReq* shmem_req, Byte* cach
       case DirectoryState::UNCACHED:
       {
          MYLOG("%lx is UNCACHED", address);
-         assert (sharers_list_pair.second.size() == 0);
+         assert (sharers_list.size() == 0);
 
          // Modifiy the directory entry contents
          bool add_result = directory_entry->addSharer(requester, m_dram_directory_cache->getMaxHwSharers());
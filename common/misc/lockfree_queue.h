@@ -0,0 +1,63 @@
+#ifndef LOCKFREE_QUEUE_H
+#define LOCKFREE_QUEUE_H
+
+#include "fixed_types.h"
+
+// Unbounded multiple-producer, single-consumer FIFO queue without locks [Vyukov].
+// push() may be called concurrently from any thread, pop() and empty() only from the one consumer thread.
+// A push that is still in progress may be invisible to the consumer for a short while,
+// so a consumer that blocks when the queue is empty needs to re-check after announcing it will sleep.
+template <class T> class LockFreeQueue
+{
+   private:
+      struct Node
+      {
+         Node(const T& _value) : next(NULL), value(_value) {}
+         Node* volatile next;
+         T value;
+      };
+
+      Node* m_head; // Most recently pushed node, written by the producers
+      char m_padding[64 - sizeof(Node*)];
+      Node* m_tail; // Dummy node before the oldest element, owned by the consumer
+
+   public:
+      LockFreeQueue()
+      {
+         m_head = m_tail = new Node(T());
+      }
+
+      ~LockFreeQueue()
+      {
+         T t;
+         while (pop(t))
+            ;
+         delete m_tail;
+      }
+
+      void push(const T& t)
+      {
+         Node* node = new Node(t);
+         Node* prev = __atomic_exchange_n(&m_head, node, __ATOMIC_SEQ_CST);
+         __atomic_store_n(&prev->next, node, __ATOMIC_SEQ_CST);
+      }
+
+      bool pop(T& t)
+      {
+         Node* next = __atomic_load_n(&m_tail->next, __ATOMIC_SEQ_CST);
+         if (next == NULL)
+            return false;
+
+         t = next->value;
+         delete m_tail;
+         m_tail = next;
+         return true;
+      }
+
+      bool empty() const
+      {
+         return __atomic_load_n(&m_tail->next, __ATOMIC_SEQ_CST) == NULL;
+      }
+};
+
+#endif // LOCKFREE_QUEUE_H
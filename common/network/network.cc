@@ -1,4 +1,5 @@
 #include <string.h>
+#include <algorithm>
 
 #include "transport.h"
 #include "core.h"
@@ -78,7 +79,8 @@ void Network::netPullFromTransport()
    {
       LOG_PRINT("Entering netPullFromTransport");
 
-      NetPacket packet(_transport->recv());
+      Byte *buffer = _transport->recv();
+      NetPacket packet(buffer);
 
       LOG_PRINT("Pull packet : type %i, from %i, time %s", (SInt32)packet.type, packet.sender, itostr(packet.time).c_str());
       assert(0 <= packet.sender && packet.sender < _numMod);
@@ -95,8 +97,7 @@ void Network::netPullFromTransport()
          // if this isn't a broadcast message, then we shouldn't process it further
          if (packet.receiver != NetPacket::BROADCAST)
          {
-            if (packet.length > 0)
-               delete [] (Byte*) packet.data;
+            delete [] buffer;
             continue;
          }
       }
@@ -117,8 +118,7 @@ void Network::netPullFromTransport()
 
          callback(_callbackObjs[packet.type], packet);
 
-         if (packet.length > 0)
-            delete [] (Byte*) packet.data;
+         delete [] buffer;
       }
 
       // synchronous I/O support
@@ -126,8 +126,18 @@ void Network::netPullFromTransport()
       {
          LOG_PRINT("Enqueuing packet : type %i, from %i, to %i, core_id %i, time %s.",
                (SInt32)packet.type, packet.sender, packet.receiver, _core->getId(), itostr(packet.time).c_str());
+
+         // netRecv callers own the data of the packets they receive, so give this one its own copy
+         if (packet.length > 0)
+         {
+            Byte *data = new Byte[packet.length];
+            memcpy(data, packet.data, packet.length);
+            packet.data = data;
+         }
+         delete [] buffer;
+
          _netQueueLock.acquire();
-         _netQueue.push_back(packet);
+         _netQueue[std::make_pair(packet.sender, packet.type)].push_back(packet);
          _netQueueLock.release();
          _netQueueCond.broadcast();
       }
@@ -196,7 +206,14 @@ SInt32 Network::netSend(NetPacket& packet)
       buff_pkt->time = hopVec[i].time;
       buff_pkt->receiver = hopVec[i].final_dest;
 
-      _transport->send(hopVec[i].next_dest, buffer, packet.bufferSize());
+      if (i == hopVec.size() - 1)
+      {
+         // Last hop: hand the buffer over to the receiver instead of copying it
+         _transport->sendBuffer(hopVec[i].next_dest, buffer, packet.bufferSize());
+         buffer = NULL;
+      }
+      else
+         _transport->send(hopVec[i].next_dest, buffer, packet.bufferSize());
 
       LOG_PRINT("Sent packet");
    }
@@ -206,104 +223,64 @@ SInt32 Network::netSend(NetPacket& packet)
    return packet.length;
 }
 
-// Stupid helper class to eliminate special cases for empty
-// sender/type vectors in a NetMatch
-class NetRecvIterator
+// Keep track of the earliest packet in queue q
+static void checkQueue(NetQueueMap::iterator q, bool &found, NetQueueMap::iterator &queue, NetQueue::iterator &packet)
 {
-   public:
-      NetRecvIterator(UInt32 i)
-            : _mode(INT)
-            , _max(i)
-            , _i(0)
-      {
-      }
-      NetRecvIterator(const std::vector<SInt32> &v)
-            : _mode(SENDER_VECTOR)
-            , _senders(&v)
-            , _i(0)
-      {
-      }
-      NetRecvIterator(const std::vector<PacketType> &v)
-            : _mode(TYPE_VECTOR)
-            , _types(&v)
-            , _i(0)
+   for (NetQueue::iterator i = q->second.begin(); i != q->second.end(); ++i)
+   {
+      if (!found || packet->time > i->time)
       {
+         found = true;
+         queue = q;
+         packet = i;
       }
+   }
+}
 
-      inline UInt32 get()
-      {
-         switch (_mode)
-         {
-         case INT:
-            return _i;
-         case SENDER_VECTOR:
-            return (UInt32)_senders->at(_i);
-         case TYPE_VECTOR:
-            return (UInt32)_types->at(_i);
-         default:
-            assert(false);
-            return (UInt32)-1;
-         };
-      }
+// Find the earliest queued packet matching match, looking only at the (sender, type) queues it selects.
+// Must be called with _netQueueLock held.
+bool Network::findEarliest(const NetMatch &match, NetQueueMap::iterator &queue, NetQueue::iterator &packet)
+{
+   bool found = false;
 
-      inline Boolean done()
+   if (!match.senders.empty() && !match.types.empty())
+   {
+      // Fully specified: direct lookups
+      for (std::vector<SInt32>::const_iterator s = match.senders.begin(); s != match.senders.end(); ++s)
       {
-         switch (_mode)
+         for (std::vector<PacketType>::const_iterator t = match.types.begin(); t != match.types.end(); ++t)
          {
-         case INT:
-            return _i >= _max;
-         case SENDER_VECTOR:
-            return _i >= _senders->size();
-         case TYPE_VECTOR:
-            return _i >= _types->size();
-         default:
-            assert(false);
-            return true;
-         };
-      }
-
-      inline void next()
-      {
-         ++_i;
+            NetQueueMap::iterator q = _netQueue.find(std::make_pair(*s, *t));
+            if (q != _netQueue.end())
+               checkQueue(q, found, queue, packet);
+         }
       }
-
-      inline void reset()
+   }
+   else
+   {
+      // Wildcard sender or type: walk all non-empty queues
+      for (NetQueueMap::iterator q = _netQueue.begin(); q != _netQueue.end(); ++q)
       {
-         _i = 0;
+         if (!match.senders.empty() && std::find(match.senders.begin(), match.senders.end(), q->first.first) == match.senders.end())
+            continue;
+         if (!match.types.empty() && std::find(match.types.begin(), match.types.end(), q->first.second) == match.types.end())
+            continue;
+         checkQueue(q, found, queue, packet);
       }
+   }
 
-   private:
-      enum
-      {
-         INT, SENDER_VECTOR, TYPE_VECTOR
-      } _mode;
-
-      union
-      {
-         UInt32 _max;
-         const std::vector<SInt32> *_senders;
-         const std::vector<PacketType> *_types;
-      };
-
-      UInt32 _i;
-};
+   return found;
+}
 
 NetPacket Network::netRecv(const NetMatch &match, UInt64 timeout_ns)
 {
    LOG_PRINT("Entering netRecv.");
 
    // Track via iterator to minimize copying
+   NetQueueMap::iterator queue;
    NetQueue::iterator itr;
    Boolean found = false, retry = true;
 
-   NetRecvIterator sender = match.senders.empty()
-                            ? NetRecvIterator(_numMod)
-                            : NetRecvIterator(match.senders);
-
-   NetRecvIterator type = match.types.empty()
-                          ? NetRecvIterator((UInt32)NUM_PACKET_TYPES)
-                          : NetRecvIterator(match.types);
-
    LOG_ASSERT_ERROR(_core && _core->getPerformanceModel(),
                     "Core and/or performance model not initialized.");
    SubsecondTime start_time = _core->getPerformanceModel()->getElapsedTime();
@@ -312,35 +289,7 @@ NetPacket Network::netRecv(const NetMatch &match, UInt64 timeout_ns)
 
    while (!found)
    {
-      itr = _netQueue.end();
-
-      // check every entry in the queue
-      for (NetQueue::iterator i = _netQueue.begin();
-            i != _netQueue.end();
-            i++)
-      {
-         // only find packets that match
-         for (sender.reset(); !sender.done(); sender.next())
-         {
-            if (i->sender != (SInt32)sender.get())
-               continue;
-
-            for (type.reset(); !type.done(); type.next())
-            {
-               if (i->type != (PacketType)type.get())
-                  continue;
-
-               found = true;
-
-               // find the earliest packet
-               if (itr == _netQueue.end() ||
-                   itr->time > i->time)
-               {
-                  itr = i;
-               }
-            }
-         }
-      }
+      found = findEarliest(match, queue, itr);
 
       if (!found)
       {
@@ -362,14 +311,16 @@ NetPacket Network::netRecv(const NetMatch &match, UInt64 timeout_ns)
       }
    }
 
-   assert(found == true && itr != _netQueue.end());
+   assert(found == true && itr != queue->second.end());
    assert(0 <= itr->sender && itr->sender < _numMod);
    assert(0 <= itr->type && itr->type < NUM_PACKET_TYPES);
    assert((itr->receiver == _core->getId()) || (itr->receiver == NetPacket::BROADCAST));
 
    // Copy result
    NetPacket packet = *itr;
-   _netQueue.erase(itr);
+   queue->second.erase(itr);
+   if (queue->second.empty())
+      _netQueue.erase(queue);
    _netQueueLock.release();
 
    LOG_PRINT("packet.time(%s), start_time(%s)", itostr(packet.time).c_str(), itostr(start_time).c_str());
@@ -510,14 +461,7 @@ NetPacket::NetPacket(Byte *buffer)
    memcpy(this, buffer, sizeof(*this));
 
    // LOG_ASSERT_ERROR(length > 0, "type(%u), sender(%i), receiver(%i), length(%u)", type, sender, receiver, length);
-   if (length > 0)
-   {
-      Byte* data_buffer = new Byte[length];
-      memcpy(data_buffer, buffer + sizeof(*this), length);
-      data = data_buffer;
-   }
-
-   delete [] buffer;
+   data = length > 0 ? buffer + sizeof(*this) : NULL;
 }
 
 // This implementation is slightly wasteful because there is no need
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <map>
 
 // TODO: Do we need to support multicast to some (but not all)
 // destinations?
@@ -33,6 +34,7 @@ public:
    const void *data;
 
    NetPacket();
+   // Unpack a packet received from the transport: data points into buffer, which remains owned by the caller
    explicit NetPacket(Byte*);
    NetPacket(SubsecondTime time, PacketType type, SInt32 sender,
              SInt32 receiver, UInt32 length, const void *data);
@@ -44,6 +46,8 @@ public:
 };
 
 typedef std::list<NetPacket> NetQueue;
+// Received packets waiting for netRecv, indexed by (sender, type)
+typedef std::map<std::pair<SInt32, PacketType>, NetQueue> NetQueueMap;
 
 // -- Network Matches -- //
 
@@ -114,11 +118,12 @@ class Network
       SInt32 _tid;
       SInt32 _numMod;
 
-      NetQueue _netQueue;
+      NetQueueMap _netQueue;
       Lock _netQueueLock;
       ConditionVariable _netQueueCond;
 
       void forwardPacket(NetPacket& packet);
+      bool findEarliest(const NetMatch &match, NetQueueMap::iterator &queue, NetQueue::iterator &packet);
 };
 
 #endif // NETWORK_H
@@ -27,6 +27,7 @@ const char* OutputDirectionString(NetworkModelEMeshHopByHop::OutputDirection dir
 
 NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwork net_type):
    NetworkModel(net, net_type),
+   m_global_clock(false),
    m_enabled(false),
    m_total_bytes_sent(0),
    m_total_packets_sent(0),
@@ -50,6 +51,7 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwor
          clock_domain = Sim()->getDvfsManager()->getCoreDomain(m_core_id);
       } else if (domain_name == "global") {
          clock_domain = Sim()->getDvfsManager()->getGlobalDomain();
+         m_global_clock = true;
       } else {
          LOG_PRINT_ERROR("dvfs_domain %s is invalid", domain_name.c_str());
       }
@@ -91,6 +93,7 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwor
    }
 
    createQueueModels(name);
+   computeRoutes();
 }
 
 NetworkModelEMeshHopByHop::~NetworkModelEMeshHopByHop()
@@ -201,6 +204,13 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &n
             SubsecondTime curr_time = pkt.time + injection_port_queue_delay;
 
             // Unicast message to each core
+            SubsecondTime route_latency;
+            if (computeRouteLatency(i, requester, route_latency))
+            {
+               addHop(DESTINATION, i, i, curr_time + route_latency, pkt_length, nextHops, requester);
+               continue;
+            }
+
             OutputDirection direction;
             core_id_t next_dest = getNextDest(i, direction);
 
@@ -224,6 +234,14 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &n
       SubsecondTime curr_time = pkt.time + injection_port_queue_delay;
 
       // A Unicast packet
+      SubsecondTime route_latency;
+      if (computeRouteLatency(pkt.receiver, requester, route_latency))
+      {
+         // Skip the intermediate nodes and deliver straight to the destination
+         addHop(DESTINATION, pkt.receiver, pkt.receiver, curr_time + route_latency, pkt_length, nextHops, requester);
+         return;
+      }
+
       OutputDirection direction;
       core_id_t next_dest = getNextDest(pkt.receiver, direction);
 
@@ -412,37 +430,86 @@ NetworkModelEMeshHopByHop::getNextDest(SInt32 final_dest, OutputDirection& direc
       return m_core_id - m_core_id % m_concentration;
    }
 
-   SInt32 sx, sy, dx, dy;
-
-   computePosition(m_core_id, sx, sy);
-   computePosition(final_dest, dx, dy);
+   const Route &route = m_routes[final_dest / m_concentration];
+   direction = route.direction;
+   return route.next_dest;
+}
 
+NetworkModelEMeshHopByHop::OutputDirection
+NetworkModelEMeshHopByHop::computeDirection(SInt32 sx, SInt32 sy, SInt32 dx, SInt32 dy)
+{
+   // Dimension-order (XY) routing, taking the wrap-around link when that is shorter
    if ((sx > dx) ^ (m_wrap_around && abs(sx - dx) > (m_mesh_width+1) / 2))
-   {
-      direction = LEFT;
-      return computeCoreId(sx-1,sy);
-   }
+      return LEFT;
    else if (sx != dx)
-   {
-      direction = RIGHT;
-      return computeCoreId(sx+1,sy);
-   }
+      return RIGHT;
    else if ((sy > dy) ^ (m_wrap_around && abs(sy - dy) > (m_mesh_height+1) / 2))
-   {
-      direction = DOWN;
-      return computeCoreId(sx,sy-1);
-   }
+      return DOWN;
    else if (sy != dy)
+      return UP;
+   else
+      return SELF;
+}
+
+void
+NetworkModelEMeshHopByHop::computeRoutes()
+{
+   // Precompute the first hop and route length towards every node in the mesh (including those
+   // with memory controllers attached), so routing a packet does not need to redo the mesh arithmetic
+   static const SInt32 step_x[] = { 0, 0, -1, 1 }; // UP, DOWN, LEFT, RIGHT
+   static const SInt32 step_y[] = { 1, -1, 0, 0 };
+   SInt32 sx, sy, dx, dy;
+   computePosition(m_core_id, sx, sy);
+
+   m_routes.resize(m_mesh_width * m_mesh_height);
+   for (SInt32 node = 0; node < m_mesh_width * m_mesh_height; node++)
    {
-      direction = UP;
-      return computeCoreId(sx,sy+1);
+      Route &route = m_routes[node];
+      core_id_t final_dest = node * m_concentration;
+      computePosition(final_dest, dx, dy);
+
+      route.direction = computeDirection(sx, sy, dx, dy);
+      if (route.direction == SELF)
+         route.next_dest = m_core_id;
+      else
+         route.next_dest = computeCoreId(sx + step_x[route.direction], sy + step_y[route.direction]);
+
+      // Count the hops the packet actually takes: every node on the way makes its own routing decision,
+      // which on a wrap-around mesh with an odd width can be longer than the shortest distance
+      route.num_hops = 0;
+      for (SInt32 x = sx, y = sy; x != dx || y != dy; route.num_hops++)
+      {
+         LOG_ASSERT_ERROR(route.num_hops < m_mesh_width + m_mesh_height, "Route from %d to %d does not converge", m_core_id, final_dest);
+         OutputDirection direction = computeDirection(x, y, dx, dy);
+         x = (x + step_x[direction] + m_mesh_width) % m_mesh_width;
+         y = (y + step_y[direction] + m_mesh_height) % m_mesh_height;
+      }
    }
-   else
+}
+
+// Returns true if the latency from here to final_dest does not depend on per-link contention,
+// so the packet can skip the intermediate nodes. The latency of the whole route is then returned in one step.
+bool
+NetworkModelEMeshHopByHop::computeRouteLatency(core_id_t final_dest, core_id_t requester, SubsecondTime &latency)
+{
+   if (final_dest >= (core_id_t)Config::getSingleton()->getApplicationCores() || m_core_id / m_concentration == final_dest / m_concentration)
+      return false;
+
+   if ( (!m_enabled) || (requester >= (core_id_t) Config::getSingleton()->getApplicationCores()) )
    {
-      // A send to itself
-      direction = SELF;
-      return m_core_id;
+      // Not modeled: no hop latency and the link queues are not updated
+      latency = SubsecondTime::Zero();
+      return true;
    }
+
+   // Link queues need to be visited hop by hop, and with per-core clocks every node has its own hop latency.
+   // The one-step route is therefore only taken with network/emesh_hop_by_hop/queue_model/enabled=false
+   // and dvfs_domain=global; otherwise packets are forwarded node by node as before
+   if (m_queue_model_enabled || !m_global_clock)
+      return false;
+
+   latency = m_routes[final_dest / m_concentration].num_hops * m_hop_latency.getLatency();
+   return true;
 }
 
 void
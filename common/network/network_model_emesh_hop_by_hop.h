@@ -26,10 +26,21 @@ class NetworkModelEMeshHopByHop : public NetworkModel
       } OutputDirection;
 
    private:
+      // Dimension-order route from this node to a destination node
+      struct Route
+      {
+         OutputDirection direction;
+         core_id_t next_dest;
+         SInt32 num_hops;
+      };
+
       // Fields
       SInt32 m_mesh_width;
       SInt32 m_mesh_height;
 
+      std::vector<Route> m_routes; // Indexed by destination node (core_id / m_concentration)
+      bool m_global_clock; // All nodes share the same hop latency
+
       QueueModel* m_queue_models[NUM_OUTPUT_DIRECTIONS];
       QueueModel* m_injection_port_queue_model;
       QueueModel* m_ejection_port_queue_model;
@@ -56,6 +67,9 @@ class NetworkModelEMeshHopByHop : public NetworkModel
       SubsecondTime computeLatency(OutputDirection direction, SubsecondTime pkt_time, UInt32 pkt_length, core_id_t requester, subsecond_time_t *queue_delay_stats);
       SubsecondTime computeProcessingTime(UInt32 pkt_length);
       core_id_t getNextDest(core_id_t final_dest, OutputDirection& direction);
+      OutputDirection computeDirection(SInt32 sx, SInt32 sy, SInt32 dx, SInt32 dy);
+      void computeRoutes();
+      bool computeRouteLatency(core_id_t final_dest, core_id_t requester, SubsecondTime &latency);
 
       // Injection & Ejection Port Queue Models
       SubsecondTime computeInjectionPortQueueDelay(core_id_t pkt_receiver, SubsecondTime pkt_time, UInt32 pkt_length);
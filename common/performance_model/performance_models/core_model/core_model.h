@@ -29,9 +29,13 @@ class CoreModel
 
       // Return an Allocator for my type of DynamicMicroOp
       virtual Allocator* createDMOAllocator() const = 0;
+      // Return an unbounded Allocator for long-lived DynamicMicroOps (one per static micro-op)
+      virtual Allocator* createDMOTemplateAllocator() const = 0;
 
       // Populate a MicroOp's core-specific information object
       virtual DynamicMicroOp* createDynamicMicroOp(Allocator *alloc, const MicroOp *uop, ComponentPeriod period) const = 0;
+      // Duplicate a DynamicMicroOp previously created by createDynamicMicroOp
+      virtual DynamicMicroOp* copyDynamicMicroOp(Allocator *alloc, const DynamicMicroOp *uop) const = 0;
 
       virtual unsigned int getInstructionLatency(const MicroOp *uop) const = 0;
       virtual unsigned int getAluLatency(const MicroOp *uop) const = 0;
@@ -48,11 +52,21 @@ template <typename T> class BaseCoreModel : public CoreModel
          return new TypedAllocator<T, 8192>();
       }
 
+      virtual Allocator* createDMOTemplateAllocator() const
+      {
+         return new TypedAllocator<T>();
+      }
+
       DynamicMicroOp* createDynamicMicroOp(Allocator *alloc, const MicroOp *uop, ComponentPeriod period) const
       {
          T *info = DynamicMicroOp::alloc<T>(alloc, uop, this, period);
          return info;
       }
+
+      DynamicMicroOp* copyDynamicMicroOp(Allocator *alloc, const DynamicMicroOp *uop) const
+      {
+         return DynamicMicroOp::copy<T>(alloc, static_cast<const T*>(uop));
+      }
 };
 
 #endif // __CORE_MODEL
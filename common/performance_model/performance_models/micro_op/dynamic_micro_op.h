@@ -77,6 +77,13 @@ class DynamicMicroOp
          T *t = new(ptr) T(uop, core_model, period);
          return t;
       }
+      // Copy a fully initialized DynamicMicroOp, used to instantiate cached per-instruction templates
+      template<typename T> static T* copy(Allocator *alloc, const T *uop)
+      {
+         void *ptr = alloc->alloc(sizeof(T));
+         T *t = new(ptr) T(*uop);
+         return t;
+      }
       static void operator delete(void* ptr) { Allocator::dealloc(ptr); }
 
       const MicroOp *getMicroOp() const { return m_uop; }
@@ -23,6 +23,7 @@ MicroOpPerformanceModel::MicroOpPerformanceModel(Core *core, bool issue_memops)
     : PerformanceModel(core)
     , m_core_model(CoreModel::getCoreModel(Sim()->getCfg()->getStringArray("perf_model/core/core_model", core->getId())))
     , m_allocator(m_core_model->createDMOAllocator())
+    , m_template_allocator(m_core_model->createDMOTemplateAllocator())
     , m_issue_memops(issue_memops)
     , m_dyninsn_count(0)
     , m_dyninsn_cost(0)
@@ -104,6 +105,69 @@ MicroOpPerformanceModel::~MicroOpPerformanceModel()
    std::fclose(m_cycle_log);
 #endif
    delete m_allocator;
+
+   for(std::unordered_map<const Instruction*, UopTemplate*>::iterator it = m_uop_templates.begin(); it != m_uop_templates.end(); ++it)
+   {
+      for(std::vector<DynamicMicroOp*>::iterator jt = it->second->uops.begin(); jt != it->second->uops.end(); ++jt)
+         delete *jt;
+      delete it->second;
+   }
+   delete m_template_allocator;
+}
+
+const MicroOpPerformanceModel::UopTemplate* MicroOpPerformanceModel::getUopTemplate(const Instruction *instruction, const ComponentPeriod &period)
+{
+   UopTemplate *&uop_template = m_uop_templates[instruction];
+
+   if (uop_template && uop_template->period == period.getPeriod())
+      return uop_template;
+
+   if (uop_template)
+   {
+      // The core changed frequency since the template was made
+      for(std::vector<DynamicMicroOp*>::iterator it = uop_template->uops.begin(); it != uop_template->uops.end(); ++it)
+         delete *it;
+      uop_template->uops.clear();
+      uop_template->bypass_latencies.clear();
+   }
+   else
+   {
+      uop_template = new UopTemplate();
+   }
+
+   uop_template->period = period.getPeriod();
+   uop_template->num_loads = 0;
+   uop_template->num_stores = 0;
+   uop_template->exec_base_index = SIZE_MAX;
+   uop_template->load_base_index = SIZE_MAX;
+   uop_template->store_base_index = SIZE_MAX;
+
+   for(std::vector<const MicroOp*>::const_iterator it = instruction->getMicroOps()->begin(); it != instruction->getMicroOps()->end(); it++)
+   {
+      DynamicMicroOp *uop = m_core_model->createDynamicMicroOp(m_template_allocator, *it, period);
+      size_t m = uop_template->uops.size();
+      uop_template->uops.push_back(uop);
+      uop_template->bypass_latencies.push_back(uop->getMicroOp()->isLoad() || uop->getMicroOp()->isStore() ? m_core_model->getBypassLatency(uop) : 0);
+
+      if (uop->getMicroOp()->isExecute())
+      {
+         uop_template->exec_base_index = m;
+      }
+      if (uop->getMicroOp()->isStore())
+      {
+         ++uop_template->num_stores;
+         if (uop_template->store_base_index == SIZE_MAX)
+            uop_template->store_base_index = m;
+      }
+      if (uop->getMicroOp()->isLoad())
+      {
+         ++uop_template->num_loads;
+         if (uop_template->load_base_index == SIZE_MAX)
+            uop_template->load_base_index = m;
+      }
+   }
+
+   return uop_template;
 }
 
 void MicroOpPerformanceModel::doSquashing(std::vector<DynamicMicroOp*> &current_uops, uint32_t first_squashed)
@@ -165,15 +229,6 @@ void MicroOpPerformanceModel::handleInstruction(DynamicInstruction *dynins)
    UInt64 num_writes_done = 0;
    UInt64 num_nonmem_done = 0;
 
-   if (dynins->instruction->getMicroOps())
-   {
-      for(std::vector<const MicroOp*>::const_iterator it = dynins->instruction->getMicroOps()->begin(); it != dynins->instruction->getMicroOps()->end(); it++)
-      {
-         m_current_uops.push_back(m_core_model->createDynamicMicroOp(m_allocator, *it, insn_period));
-      }
-   }
-
-   // Find some information
    size_t num_loads = 0;
    size_t num_stores = 0;
    size_t exec_base_index = SIZE_MAX;
@@ -181,25 +236,21 @@ void MicroOpPerformanceModel::handleInstruction(DynamicInstruction *dynins)
    size_t load_base_index = SIZE_MAX;
    // Find the first store
    size_t store_base_index = SIZE_MAX;
-   for (size_t m = 0 ; m < m_current_uops.size() ; m++ )
+
+   const UopTemplate *uop_template = NULL;
+   if (dynins->instruction->getMicroOps())
    {
-      if (m_current_uops[m]->getMicroOp()->isExecute())
-      {
-         exec_base_index = m;
-      }
-      if (m_current_uops[m]->getMicroOp()->isStore())
-      {
-         ++num_stores;
-         if (store_base_index == SIZE_MAX)
-            store_base_index = m;
-      }
-      if (m_current_uops[m]->getMicroOp()->isLoad())
+      uop_template = getUopTemplate(dynins->instruction, insn_period);
+      for(std::vector<DynamicMicroOp*>::const_iterator it = uop_template->uops.begin(); it != uop_template->uops.end(); it++)
       {
-         ++num_loads;
-         if (load_base_index == SIZE_MAX)
-            load_base_index = m;
+         m_current_uops.push_back(m_core_model->copyDynamicMicroOp(m_allocator, *it));
       }
 
+      num_loads = uop_template->num_loads;
+      num_stores = uop_template->num_stores;
+      exec_base_index = uop_template->exec_base_index;
+      load_base_index = uop_template->load_base_index;
+      store_base_index = uop_template->store_base_index;
    }
    // Compute the iCache cost, and add to our cycle time
    if (Sim()->getConfig()->getEnableICacheModeling())
@@ -271,7 +322,7 @@ void MicroOpPerformanceModel::handleInstruction(DynamicInstruction *dynins)
                m_cache_lines_read.push_back(cache_line);
 
                // Update this uop with load latencies
-               UInt64 bypass_latency = m_core_model->getBypassLatency(m_current_uops[load_index]);
+               UInt64 bypass_latency = uop_template->bypass_latencies[load_index];
                m_current_uops[load_index]->setExecLatency(memory_cycle_latency + bypass_latency);
                Memory::Access addr;
                addr.set(info.addr);
@@ -306,7 +357,7 @@ void MicroOpPerformanceModel::handleInstruction(DynamicInstruction *dynins)
                m_cache_lines_written.push_back(cache_line);
 
                // Update this uop with store latencies.
-               UInt64 bypass_latency = m_core_model->getBypassLatency(m_current_uops[store_index]);
+               UInt64 bypass_latency = uop_template->bypass_latencies[store_index];
                m_current_uops[store_index]->setExecLatency(memory_cycle_latency + bypass_latency);
                Memory::Access addr;
                addr.set(info.addr);
@@ -8,6 +8,8 @@
 #include "subsecond_time.h"
 #include "dynamic_micro_op.h"
 
+#include <unordered_map>
+
 #define DEBUG_INSN_LOG 0
 #define DEBUG_DYN_INSN_LOG 0
 #define DEBUG_CYCLE_COUNT_LOG 0
@@ -29,13 +31,28 @@ protected:
    void doSquashing(std::vector<DynamicMicroOp*> &current_uops, uint32_t first_squashed = 0);
 
 private:
+   // DynamicMicroOps of a static instruction as created by the core model, with everything that does not
+   // depend on the dynamic instance already filled in. Each dynamic instance starts from a copy of these.
+   struct UopTemplate
+   {
+      SubsecondTime period; // Period the DynamicMicroOps were created for, rebuilt after a frequency change
+      std::vector<DynamicMicroOp*> uops;
+      std::vector<uint32_t> bypass_latencies;
+      size_t num_loads, num_stores;
+      size_t exec_base_index, load_base_index, store_base_index;
+   };
+
    void handleInstruction(DynamicInstruction *instruction);
+   const UopTemplate* getUopTemplate(const Instruction *instruction, const ComponentPeriod &period);
 
    static MicroOp* m_serialize_uop;
    static MicroOp* m_mfence_uop;
    static MicroOp* m_memaccess_uop;
 
    Allocator *m_allocator; // Per-thread allocator for DynamicMicroOps
+   Allocator *m_template_allocator;
+   // Static instructions are never deleted, so their address is a stable key
+   std::unordered_map<const Instruction*, UopTemplate*> m_uop_templates;
    const bool m_issue_memops;
 
    std::vector<DynamicMicroOp*> m_current_uops;
@@ -17,6 +17,7 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 // Define to get per-cycle printout of dispatch, issue, writeback stages
 //#define DEBUG_PERCYCLE
@@ -41,6 +42,8 @@ RobTimer::RobTimer(
       , rob(window_size + 255)
       , m_num_in_rob(0)
       , m_rs_entries_used(0)
+      , m_done_until(0)
+      , m_issue_head(0)
       , m_rob_contention(
          Sim()->getCfg()->getBoolArray("perf_model/core/rob_timer/issue_contention", core->getId())
          ? core_model->createRobContentionModel(core)
@@ -185,6 +188,7 @@ void RobTimer::RobEntry::init(DynamicMicroOp *_uop, UInt64 sequenceNumber)
    readyMax = SubsecondTime::Zero();
    addressReady = SubsecondTime::MaxTime();
    addressReadyMax = SubsecondTime::Zero();
+   dispatched = SubsecondTime::MaxTime();
    issued = SubsecondTime::MaxTime();
    done = SubsecondTime::MaxTime();
 
@@ -502,6 +506,10 @@ SubsecondTime RobTimer::doDispatch(SubsecondTime **cpiComponent)
          // If uop is already ready, we may need to issue it in the following cycle
          entry->ready = std::max(entry->ready, (now + 1ul).getElapsedTime());
          next_event = std::min(next_event, entry->ready);
+         if (entry->ready != SubsecondTime::MaxTime())
+            scheduleIssue(entry);
+         if (uop.getMicroOp()->isStore())
+            m_unissued_stores.push_back(uop.getSequenceNumber());
 
          #ifdef DEBUG_PERCYCLE
             std::cout<<"DISPATCH "<<entry->uop->getMicroOp()->toShortString()<<std::endl;
@@ -564,9 +572,52 @@ SubsecondTime RobTimer::doDispatch(SubsecondTime **cpiComponent)
       return std::min(frontend_stalled_until, next_event);
 }
 
-void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
+void RobTimer::scheduleIssue(RobEntry *entry)
+{
+   if (entry->ready <= now)
+      m_ready_list.insert(entry->uop->getSequenceNumber());
+   else
+      m_waiting.push(TimedUop(entry->ready, entry->uop->getSequenceNumber()));
+}
+
+uint64_t RobTimer::getOldestUnissued()
+{
+   while(m_issue_head < m_num_in_rob && rob.at(m_issue_head).done != SubsecondTime::MaxTime())
+      ++m_issue_head;
+   return m_issue_head < m_num_in_rob ? rob.at(m_issue_head).uop->getSequenceNumber() : INVALID_SEQNR;
+}
+
+bool RobTimer::hasUnresolvedStore(uint64_t sequenceNumber)
+{
+   for(std::deque<uint64_t>::const_iterator it = m_unissued_stores.begin(); it != m_unissued_stores.end() && *it < sequenceNumber; ++it)
+      if (findEntryBySequenceNumber(*it)->addressReady > now)
+         return true;
+   return false;
+}
+
+void RobTimer::pruneCompletions()
+{
+   // Done uops no longer generate events, remember the youngest one for getNextCompletion
+   while(!m_completions.empty() && m_completions.front().first <= now)
+   {
+      m_done_until = std::max(m_done_until, m_completions.front().second + 1);
+      std::pop_heap(m_completions.begin(), m_completions.end(), std::greater<TimedUop>());
+      m_completions.pop_back();
+   }
+}
+
+SubsecondTime RobTimer::getNextCompletion()
+{
+   pruneCompletions();
+   // A done uop that was not committed yet keeps the timer from skipping, as when the ROB was scanned
+   uint64_t first = rob.size() ? rob.front().uop->getSequenceNumber() : nextSequenceNumber;
+   if (m_done_until > first)
+      return now.getElapsedTime();
+   return m_completions.empty() ? SubsecondTime::MaxTime() : m_completions.front().first;
+}
+
+void RobTimer::issueInstruction(RobEntry *entry)
 {
-   RobEntry *entry = &rob[idx];
    DynamicMicroOp &uop = *entry->uop;
 
    if ((uop.getMicroOp()->isLoad() || uop.getMicroOp()->isStore())
@@ -628,7 +679,15 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
 
    entry->issued = now;
    entry->done = cycle_done;
-   next_event = std::min(next_event, entry->done);
+   m_completions.push_back(TimedUop(entry->done, uop.getSequenceNumber()));
+   std::push_heap(m_completions.begin(), m_completions.end(), std::greater<TimedUop>());
+
+   if (uop.getMicroOp()->isStore())
+   {
+      // Stores only issue from the head of the ROB, so they leave m_unissued_stores in order
+      LOG_ASSERT_ERROR(m_unissued_stores.front() == uop.getSequenceNumber(), "Store %" PRIu64 " issued out of order", uop.getSequenceNumber());
+      m_unissued_stores.pop_front();
+   }
 
    --m_rs_entries_used;
 
@@ -648,8 +707,12 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
       // If all dependencies are resolved, mark the uop ready
       if (depEntry->uop->getDependenciesLength() == 0)
       {
+         bool wakeup = depEntry->ready == SubsecondTime::MaxTime();
          depEntry->ready = depEntry->readyMax;
          //std::cout<<"    ready @ "<<depEntry->ready<<std::endl;
+         // Uops still in the pre-ROB buffer are scheduled when they are dispatched
+         if (wakeup && depEntry->dispatched != SubsecondTime::MaxTime())
+            scheduleIssue(depEntry);
       }
 
       // For stores, check if their address has been produced
@@ -697,35 +760,37 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
 SubsecondTime RobTimer::doIssue()
 {
    uint64_t num_issued = 0;
-   SubsecondTime next_event = SubsecondTime::MaxTime();
-   bool head_of_queue = true, no_more_load = false, no_more_store = false, have_unresolved_store = false;
+   bool visited = false, no_more_load = false, no_more_store = false;
 
    if (m_rob_contention)
       m_rob_contention->initCycle(now);
 
-   for(uint64_t i = 0; i < m_num_in_rob; ++i)
+   // Uops whose operands are available by now can be considered for issue
+   while(!m_waiting.empty() && m_waiting.top().first <= now)
    {
-      RobEntry *entry = &rob.at(i);
-      DynamicMicroOp *uop = entry->uop;
+      m_ready_list.insert(m_waiting.top().second);
+      m_waiting.pop();
+   }
 
+   // Visit the ready uops in program order. Uops that were already issued or are still waiting on a dependency
+   // cannot issue this cycle, they only block younger uops through head_of_queue and unresolved store addresses.
+   for(std::set<uint64_t>::iterator it = m_ready_list.begin(); it != m_ready_list.end(); )
+   {
+      RobEntry *entry = findEntryBySequenceNumber(*it);
+      DynamicMicroOp *uop = entry->uop;
+      bool head_of_queue = *it == getOldestUnissued();
 
-      if (entry->done != SubsecondTime::MaxTime())
-      {
-         next_event = std::min(next_event, entry->done);
-         continue;                     // already done
-      }
+      if (inorder && !head_of_queue)
+         break;                     // In-order: only issue from head of the ROB
 
-      next_event = std::min(next_event, entry->ready);
+      visited = true;
 
 
       // See if we can issue this instruction
 
       bool canIssue = false;
 
-      if (entry->ready > now)
-         canIssue = false;          // blocked by dependency
-
-      else if ((no_more_load && uop->getMicroOp()->isLoad()) || (no_more_store && uop->getMicroOp()->isStore()))
+      if ((no_more_load && uop->getMicroOp()->isLoad()) || (no_more_store && uop->getMicroOp()->isStore()))
          canIssue = false;          // blocked by mfence
 
       else if (uop->getMicroOp()->isSerializing())
@@ -752,7 +817,7 @@ SubsecondTime RobTimer::doIssue()
       else if (uop->getMicroOp()->isLoad() && !load_queue.hasFreeSlot(now))
          canIssue = false;          // load queue full
 
-      else if (uop->getMicroOp()->isLoad() && m_no_address_disambiguation && have_unresolved_store)
+      else if (uop->getMicroOp()->isLoad() && m_no_address_disambiguation && hasUnresolvedStore(*it))
          canIssue = false;          // preceding store with unknown address
 
       else if (uop->getMicroOp()->isStore() && (!head_of_queue || !store_queue.hasFreeSlot(now)))
@@ -770,7 +835,9 @@ SubsecondTime RobTimer::doIssue()
       if (canIssue)
       {
          num_issued++;
-         issueInstruction(i, next_event);
+         issueInstruction(entry);
+         // Dependants that became ready right away were inserted after us, erase() continues with them
+         it = m_ready_list.erase(it);
 
          // Calculate memory-level parallelism (MLP) for long-latency loads (but ignore overlapped misses)
          if (uop->getMicroOp()->isLoad() && uop->isLongLatencyLoad() && uop->getDCacheHitWhere() != HitWhere::L1_OWN)
@@ -802,14 +869,11 @@ SubsecondTime RobTimer::doIssue()
       }
       else
       {
-         head_of_queue = false;     // Subsequent instructions are not at the head of the ROB
-
-         if (uop->getMicroOp()->isStore() && entry->addressReady > now)
-            have_unresolved_store = true;
-
          if (inorder)
             // In-order: only issue from head of the ROB
             break;
+
+         ++it;
       }
 
 
@@ -825,7 +889,26 @@ SubsecondTime RobTimer::doIssue()
       }
    }
 
-   return next_event;
+   // A ready uop was considered this cycle: come back next cycle
+   if (visited)
+      return now.getElapsedTime();
+
+   // Nothing can issue until the next uop becomes ready or completes
+   return std::min(getNextCompletion(), getNextReady());
+}
+
+SubsecondTime RobTimer::getNextReady()
+{
+   if (inorder)
+   {
+      // Only the head of the ROB can issue next, younger uops do not generate events
+      uint64_t head = getOldestUnissued();
+      return head != INVALID_SEQNR ? findEntryBySequenceNumber(head)->ready : SubsecondTime::MaxTime();
+   }
+   else
+   {
+      return m_waiting.empty() ? SubsecondTime::MaxTime() : m_waiting.top().first;
+   }
 }
 
 SubsecondTime RobTimer::doCommit(uint64_t& instructionsExecuted)
@@ -855,6 +938,8 @@ SubsecondTime RobTimer::doCommit(uint64_t& instructionsExecuted)
       entry->free();
       rob.pop();
       m_num_in_rob--;
+      if (m_issue_head > 0)
+         --m_issue_head;
 
       #ifdef ASSERT_SKIP
          LOG_ASSERT_ERROR(will_skip == false, "Cycle would have been skipped but stuff happened");
@@ -865,6 +950,11 @@ SubsecondTime RobTimer::doCommit(uint64_t& instructionsExecuted)
          break;
    }
 
+   // Everything issued up to now is done, so only uops still in the ROB remain
+   pruneCompletions();
+   LOG_ASSERT_ERROR(m_completions.size() <= m_num_in_rob, "%" PRIu64 " uops pending completion with only %" PRIu64 " uops in the ROB",
+                    (uint64_t)m_completions.size(), m_num_in_rob);
+
    if (rob.size())
       return rob.front().done;
    else
@@ -918,6 +1008,20 @@ void RobTimer::execute(uint64_t& instructionsExecuted, SubsecondTime& latency)
       std::cout<<"Next event: D("<<next_dispatch<<") I("<<next_issue<<") C("<<next_commit<<")"<<std::endl;
    #endif
    SubsecondTime next_event = std::min(next_dispatch, std::min(next_issue, next_commit));
+
+   // Stall fast path: while the ROB is full behind a long-latency uop at its head (usually a cache miss),
+   // dispatch waits for the head to commit and the dependants of issued uops were already scheduled at issue time.
+   // Completions of younger uops are therefore no-op events, so jump straight to the head's completion
+   // or to the next uop becoming ready. The MLP histogram needs every completion, so it disables this.
+   if (m_num_in_rob == windowSize && m_ready_list.empty() && !m_mlp_histogram
+       && next_event != SubsecondTime::MaxTime() && next_event > now + 1ul)
+   {
+      SubsecondTime stall_until = std::min(next_commit, getNextReady());
+      // The CPI component can change when a front-end stall ends, so don't jump across that
+      if (stall_until != SubsecondTime::MaxTime() && (frontend_stalled_until <= now || frontend_stalled_until >= stall_until))
+         next_event = stall_until;
+   }
+
    SubsecondTime skip;
    if (next_event != SubsecondTime::MaxTime() && next_event > now + 1ul)
    {
@@ -956,10 +1060,13 @@ void RobTimer::countOutstandingMemop(SubsecondTime time)
 {
    UInt64 counts[HitWhere::NUM_HITWHERES] = {0}, total = 0;
 
-   for(unsigned int i = 0; i < m_num_in_rob; ++i)
+   // Uops done before now were pruned at commit, so only uops still executing remain
+   for(std::vector<TimedUop>::const_iterator it = m_completions.begin(); it != m_completions.end(); ++it)
    {
-      RobEntry *e = &rob.at(i);
-      if (e->done != SubsecondTime::MaxTime() && e->done > now && e->uop->getMicroOp()->isLoad())
+      if (it->first <= now)
+         continue;
+      RobEntry *e = findEntryBySequenceNumber(it->second);
+      if (e->uop->getMicroOp()->isLoad())
       {
          ++counts[e->uop->getDCacheHitWhere()];
          ++total;
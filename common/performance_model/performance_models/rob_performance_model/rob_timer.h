@@ -10,6 +10,8 @@
 #include "stats.h"
 
 #include <deque>
+#include <set>
+#include <queue>
 
 class RobTimer
 {
@@ -60,6 +62,18 @@ private:
    Rob rob;
    uint64_t m_num_in_rob;
    uint64_t m_rs_entries_used;
+
+   // Issue scheduling: dispatched uops move from m_waiting to m_ready_list once their operands are available,
+   // so the issue stage only visits uops that can actually issue. m_completions holds the completion times of
+   // issued uops that are not yet done, so it never holds more entries than the ROB.
+   typedef std::pair<SubsecondTime, uint64_t> TimedUop; // (time, sequence number)
+   typedef std::priority_queue<TimedUop, std::vector<TimedUop>, std::greater<TimedUop> > TimedUopQueue;
+   TimedUopQueue m_waiting;
+   std::set<uint64_t> m_ready_list;
+   std::vector<TimedUop> m_completions;    // Min-heap on completion time
+   uint64_t m_done_until;                  // One past the sequence number of the youngest uop removed from m_completions
+   std::deque<uint64_t> m_unissued_stores; // Dispatched stores not yet issued, in program order
+   uint64_t m_issue_head;                  // ROB index at or before the oldest uop that was not yet issued
    RobContention *m_rob_contention;
 
    ComponentTime now;
@@ -145,7 +159,13 @@ private:
    SubsecondTime doIssue();
    SubsecondTime doCommit(uint64_t& instructionsExecuted);
 
-   void issueInstruction(uint64_t idx, SubsecondTime &next_event);
+   void issueInstruction(RobEntry *entry);
+   void scheduleIssue(RobEntry *entry);
+   uint64_t getOldestUnissued();
+   bool hasUnresolvedStore(uint64_t sequenceNumber);
+   void pruneCompletions();
+   SubsecondTime getNextCompletion();
+   SubsecondTime getNextReady();
 
 public:
 
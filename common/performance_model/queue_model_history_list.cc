@@ -7,8 +7,11 @@
 #include "stats.h"
 #include "config.hpp"
 
+#include <algorithm>
+
 QueueModelHistoryList::QueueModelHistoryList(String name, UInt32 id, SubsecondTime min_processing_time):
    m_min_processing_time(min_processing_time),
+   m_free_interval_first(0),
    m_utilized_time(SubsecondTime::Zero()),
    m_total_queue_delay(SubsecondTime::Zero()),
    m_total_requests(0),
@@ -39,7 +42,9 @@ QueueModelHistoryList::QueueModelHistoryList(String name, UInt32 id, SubsecondTi
    m_max_free_interval_list_size = max_list_size;
    m_average_delay = MovingAverage<SubsecondTime>::createAvgType(MovingAverage<SubsecondTime>::ARITHMETIC_MEAN, max_list_size);
    SubsecondTime max_simulation_time = SubsecondTime::FS() << 63;
-   m_free_interval_list.push_back(std::pair<const SubsecondTime,SubsecondTime>(SubsecondTime::Zero(), max_simulation_time));
+   // Room for max_list_size live intervals, one being split, and a head of max_list_size trimmed ones
+   m_free_interval_list.reserve(2 * max_list_size + 2);
+   m_free_interval_list.push_back(FreeInterval(SubsecondTime::Zero(), max_simulation_time));
 
    registerStatsMetric(name, id, "num-requests", &m_total_requests);
    registerStatsMetric(name, id, "num-requests-analytical", &m_total_requests_using_analytical_model);
@@ -55,7 +60,7 @@ QueueModelHistoryList::~QueueModelHistoryList()
 SubsecondTime
 QueueModelHistoryList::computeQueueDelay(SubsecondTime pkt_time, SubsecondTime processing_time, core_id_t requester)
 {
-   LOG_ASSERT_ERROR(m_free_interval_list.size() >= 1,
+   LOG_ASSERT_ERROR(getFreeIntervalListSize() >= 1,
          "Free Interval list size < 1");
 
    SubsecondTime queue_delay;
@@ -63,8 +68,8 @@ QueueModelHistoryList::computeQueueDelay(SubsecondTime pkt_time, SubsecondTime p
    // Check if it is an old packet
    // If yes, use analytical model
    // If not, use the history list based queue model
-   std::pair<SubsecondTime,SubsecondTime> oldest_interval = m_free_interval_list.front();
-   if (m_analytical_model_enabled && ((pkt_time + processing_time) <= oldest_interval.first))
+   const FreeInterval &oldest_interval = *getFreeIntervalListBegin();
+   if (m_analytical_model_enabled && ((pkt_time + processing_time) <= oldest_interval.start))
    {
       // Increment the number of requests that use the analytical model
       m_total_requests_using_analytical_model ++;
@@ -88,8 +93,7 @@ QueueModelHistoryList::computeQueueDelay(SubsecondTime pkt_time, SubsecondTime p
 float
 QueueModelHistoryList::getQueueUtilization()
 {
-   std::pair<SubsecondTime,SubsecondTime> newest_interval = m_free_interval_list.back();
-   SubsecondTime total_time = newest_interval.first;
+   SubsecondTime total_time = m_free_interval_list.back().start;
 
    if (total_time == SubsecondTime::Zero())
    {
@@ -137,58 +141,85 @@ QueueModelHistoryList::computeUsingAnalyticalModel(SubsecondTime pkt_time, Subse
    return m_average_delay->compute();
 }
 
+static bool endsBefore(const QueueModelHistoryList::FreeInterval &interval, SubsecondTime time)
+{
+   return interval.end < time;
+}
+
+static bool startsAfter(SubsecondTime time, const QueueModelHistoryList::FreeInterval &interval)
+{
+   return time < interval.start;
+}
+
 SubsecondTime
 QueueModelHistoryList::computeUsingHistoryList(SubsecondTime pkt_time, SubsecondTime processing_time)
 {
-   LOG_ASSERT_ERROR(m_free_interval_list.size() <= m_max_free_interval_list_size,
-         "Free Interval list size(%u) > %u", m_free_interval_list.size(), m_max_free_interval_list_size);
+   LOG_ASSERT_ERROR(getFreeIntervalListSize() <= m_max_free_interval_list_size,
+         "Free Interval list size(%u) > %u", getFreeIntervalListSize(), m_max_free_interval_list_size);
    SubsecondTime queue_delay = SubsecondTime::MaxTime();
 
-   FreeIntervalList::iterator curr_it;
-   for (curr_it = m_free_interval_list.begin(); curr_it != m_free_interval_list.end(); curr_it ++)
+   // Find the first free interval that either holds the complete request, or starts after the request arrives.
+   // Intervals are sorted and disjoint so both their start and end times are increasing:
+   // the first one ending late enough and the first one starting after pkt_time can be found by binary search.
+   FreeIntervalList::iterator begin = getFreeIntervalListBegin();
+   FreeIntervalList::iterator curr_it = std::min(
+      std::lower_bound(begin, m_free_interval_list.end(), pkt_time + processing_time, endsBefore),
+      std::upper_bound(begin, m_free_interval_list.end(), pkt_time, startsAfter));
+   LOG_ASSERT_ERROR(curr_it != m_free_interval_list.end(), "queue delay(%s), free interval not found", itostr(queue_delay).c_str());
+
+   FreeInterval interval = *curr_it;
+   // Up to two parts of the interval remain free
+   FreeInterval remaining[2] = { interval, interval };
+   UInt32 num_remaining = 0;
+
+   if (pkt_time >= interval.start)
    {
-      std::pair<SubsecondTime,SubsecondTime> interval = (*curr_it);
-
-      if ((pkt_time >= interval.first) && ((pkt_time + processing_time) <= interval.second))
+      // pkt_time + processing_time <= interval.end
+      queue_delay = SubsecondTime::Zero();
+      if ((pkt_time - interval.start) >= m_min_processing_time)
+      {
+         remaining[num_remaining++] = FreeInterval(interval.start, pkt_time);
+      }
+      if ((interval.end - (pkt_time + processing_time)) >= m_min_processing_time)
       {
-         queue_delay = SubsecondTime::Zero();
-         // Adjust the data structure accordingly
-         curr_it = m_free_interval_list.erase(curr_it);
-         if ((pkt_time - interval.first) >= m_min_processing_time)
-         {
-            m_free_interval_list.insert(curr_it, std::pair<SubsecondTime,SubsecondTime>(interval.first, pkt_time));
-         }
-         if ((interval.second - (pkt_time + processing_time)) >= m_min_processing_time)
-         {
-            m_free_interval_list.insert(curr_it, std::pair<SubsecondTime,SubsecondTime>(pkt_time + processing_time, interval.second));
-         }
-         break;
+         remaining[num_remaining++] = FreeInterval(pkt_time + processing_time, interval.end);
       }
-      // WH: The request comes before this free part, but doesn't fit. It doesn't make sense to me to
-      //     demand a fit and move this request down even further. In reality, this request would have most
-      //     likely executed at interval.first, while later request would/could be delayed. But it's too late
-      //     for that now.
-      //     (If we assume all wait times are additive then the average works out by shifting it down,
-      //      but since this is an interactive simulation all delays propagate through the system
-      //      so this won't be accurate.)
-      else if ((pkt_time < interval.first) /*&& ((interval.first + processing_time) <= interval.second)*/)
+   }
+   // WH: The request comes before this free part, but doesn't fit. It doesn't make sense to me to
+   //     demand a fit and move this request down even further. In reality, this request would have most
+   //     likely executed at interval.first, while later request would/could be delayed. But it's too late
+   //     for that now.
+   //     (If we assume all wait times are additive then the average works out by shifting it down,
+   //      but since this is an interactive simulation all delays propagate through the system
+   //      so this won't be accurate.)
+   else
+   {
+      queue_delay = interval.start - pkt_time;
+      // The request may not fit in this interval, written so it cannot underflow (which used to leave behind an inverted interval)
+      if (interval.end >= interval.start + processing_time + m_min_processing_time)
       {
-         queue_delay = interval.first - pkt_time;
-         // Adjust the data structure accordingly
-         curr_it = m_free_interval_list.erase(curr_it);
-         if ((interval.second - (interval.first + processing_time)) >= m_min_processing_time)
-         {
-            m_free_interval_list.insert(curr_it, std::pair<SubsecondTime,SubsecondTime>(interval.first + processing_time, interval.second));
-         }
-         break;
+         remaining[num_remaining++] = FreeInterval(interval.start + processing_time, interval.end);
       }
    }
 
-   LOG_ASSERT_ERROR(queue_delay != SubsecondTime::MaxTime(), "queue delay(%s), free interval not found", itostr(queue_delay).c_str());
+   // Adjust the data structure accordingly
+   if (num_remaining == 0)
+      m_free_interval_list.erase(curr_it);
+   else
+   {
+      *curr_it = remaining[0];
+      if (num_remaining == 2)
+         m_free_interval_list.insert(curr_it + 1, remaining[1]);
+   }
 
-   if (m_free_interval_list.size() > m_max_free_interval_list_size)
+   if (getFreeIntervalListSize() > m_max_free_interval_list_size)
    {
-      m_free_interval_list.erase(m_free_interval_list.begin());
+      // Drop the oldest interval, compact once enough of them have been dropped
+      if (++m_free_interval_first >= m_max_free_interval_list_size)
+      {
+         m_free_interval_list.erase(m_free_interval_list.begin(), getFreeIntervalListBegin());
+         m_free_interval_first = 0;
+      }
    }
 
    LOG_PRINT("HistoryList: pkt_time(%s), processing_time(%s), queue_delay(%s)", itostr(pkt_time).c_str(), itostr(processing_time).c_str(), itostr(queue_delay).c_str());
@@ -1,7 +1,7 @@
 #ifndef __QUEUE_MODEL_HISTORY_LIST_H__
 #define __QUEUE_MODEL_HISTORY_LIST_H__
 
-#include <list>
+#include <vector>
 
 #include "queue_model.h"
 #include "fixed_types.h"
@@ -10,7 +10,12 @@
 class QueueModelHistoryList : public QueueModel
 {
 public:
-   typedef std::list<std::pair<SubsecondTime,SubsecondTime> > FreeIntervalList;
+   struct FreeInterval
+   {
+      FreeInterval(SubsecondTime _start, SubsecondTime _end) : start(_start), end(_end) {}
+      SubsecondTime start, end;
+   };
+   typedef std::vector<FreeInterval> FreeIntervalList;
 
    QueueModelHistoryList(String name, UInt32 id, SubsecondTime min_processing_time);
    ~QueueModelHistoryList();
@@ -24,7 +29,11 @@ private:
    SubsecondTime m_min_processing_time;
    UInt32 m_max_free_interval_list_size;
 
+   // Free intervals, sorted and disjoint, in m_free_interval_list[m_free_interval_first..].
+   // Storage is reserved up front. Dropping the oldest interval only advances m_free_interval_first,
+   // the unused head is removed once it has grown to m_max_free_interval_list_size entries.
    FreeIntervalList m_free_interval_list;
+   UInt32 m_free_interval_first;
 
    // Tracks queue utilization
    SubsecondTime m_utilized_time;
@@ -38,6 +47,9 @@ private:
    UInt64 m_total_requests;
    UInt64 m_total_requests_using_analytical_model;
 
+   UInt32 getFreeIntervalListSize() const { return m_free_interval_list.size() - m_free_interval_first; }
+   FreeIntervalList::iterator getFreeIntervalListBegin() { return m_free_interval_list.begin() + m_free_interval_first; }
+
    void updateQueueUtilization(SubsecondTime processing_time);
    void updateAverageDelay(SubsecondTime queue_delay);
    SubsecondTime computeUsingHistoryList(SubsecondTime pkt_time, SubsecondTime processing_time);
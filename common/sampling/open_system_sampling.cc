@@ -0,0 +1,239 @@
+#include "open_system_sampling.h"
+#include "sampling_manager.h"
+#include "simulator.h"
+#include "core_manager.h"
+#include "thread.h"
+#include "performance_model.h"
+#include "fastforward_performance_model.h"
+#include "dvfs_manager.h"
+#include "config.hpp"
+#include "average.h"
+
+#include <cmath>
+
+OpenSystemSampling::OpenSystemSampling(SamplingManager *sampling_manager)
+   : SamplingAlgorithm(sampling_manager)
+   , m_detailed_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("sampling/open/detailed_interval")))
+   , m_fastforward_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("sampling/open/fastforward_interval")))
+   , m_fastforward_sync_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("sampling/open/fastforward_sync_interval")))
+   , m_warmup_interval(SubsecondTime::NS(Sim()->getCfg()->getInt("sampling/open/warmup_interval")))
+   , m_detailed_sync(Sim()->getCfg()->getBool("sampling/open/detailed_sync"))
+   , m_resample_on_dvfs(Sim()->getCfg()->getBool("sampling/open/resample_on_dvfs"))
+   , m_num_historic_cpi_intervals(Sim()->getCfg()->getInt("sampling/open/num_historic_cpi_intervals"))
+   , m_dispatch_width(Sim()->getCfg()->getInt("perf_model/core/interval_timer/dispatch_width"))
+   , m_started(false)
+   , m_periodic_last(SubsecondTime::Zero())
+   , m_fastforward_time_remaining(SubsecondTime::Zero())
+   , m_warmup_time_remaining(SubsecondTime::Zero())
+   , m_core_threads(Sim()->getConfig()->getApplicationCores(), INVALID_THREAD_ID)
+   , m_core_periods(Sim()->getConfig()->getApplicationCores(), SubsecondTime::Zero())
+   , m_time_detailed(SubsecondTime::Zero())
+   , m_time_fastforward(SubsecondTime::Zero())
+   , m_time_warmup(SubsecondTime::Zero())
+   , m_num_resamples(0)
+{
+   LOG_ASSERT_ERROR(m_fastforward_sync_interval > SubsecondTime::Zero() && m_fastforward_sync_interval <= std::max(m_fastforward_interval, m_warmup_interval), "fastforward_sync_interval must be between 0 and max(fastforward_interval, warmup_interval)");
+   LOG_ASSERT_ERROR(m_num_historic_cpi_intervals != 0, "Expected num_historic_cpi_intervals to be >= 1");
+}
+
+OpenSystemSampling::~OpenSystemSampling()
+{
+   writeReport();
+
+   for(std::unordered_map<thread_id_t, ThreadSamples*>::iterator it = m_samples.begin(); it != m_samples.end(); ++it)
+      delete it->second;
+}
+
+thread_id_t
+OpenSystemSampling::getCoreThread(core_id_t core_id) const
+{
+   Thread *thread = Sim()->getCoreManager()->getCoreFromID(core_id)->getThread();
+   return thread ? thread->getId() : INVALID_THREAD_ID;
+}
+
+void
+OpenSystemSampling::startInterval()
+{
+   for(core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      m_core_threads[core_id] = getCoreThread(core_id);
+      m_core_periods[core_id] = Sim()->getCoreManager()->getCoreFromID(core_id)->getDvfsDomain()->getPeriod();
+   }
+}
+
+void
+OpenSystemSampling::collectSamples()
+{
+   for(core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+      SubsecondTime period = core->getDvfsDomain()->getPeriod();
+      thread_id_t thread_id = getCoreThread(core_id);
+
+      // Only attribute the interval to a thread if it ran on this core, at this frequency, for all of it
+      if (thread_id == INVALID_THREAD_ID || thread_id != m_core_threads[core_id] || period != m_core_periods[core_id])
+         continue;
+
+      SubsecondTime cpi = m_sampling_manager->getCoreHistoricCPI(core, m_detailed_sync, m_detailed_interval / 5);
+      // Only use intervals where the core has been executing instructions for at least 20% of the time
+      if (cpi == SubsecondTime::Zero() || cpi == SubsecondTime::MaxTime())
+         continue;
+
+      double cycles = double(cpi.getFS()) / double(period.getFS());
+      if (m_samples.count(thread_id) == 0)
+         m_samples[thread_id] = new ThreadSamples(m_num_historic_cpi_intervals);
+      ThreadSamples *samples = m_samples[thread_id];
+      samples->history.pushCircular(cycles);
+      samples->count++;
+      samples->sum += 1. / cycles;
+      samples->sum_squares += 1. / (cycles * cycles);
+   }
+}
+
+// Set each core's fast-forward CPI from the measured CPI of the thread it is running, at the core's current frequency.
+// Returns true when the current configuration warrants a new detailed interval.
+bool
+OpenSystemSampling::updateFastForwardCPIs()
+{
+   bool resample = false;
+
+   for(core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); ++core_id)
+   {
+      Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+      SubsecondTime period = core->getDvfsDomain()->getPeriod();
+      thread_id_t thread_id = getCoreThread(core_id);
+      SubsecondTime cpi;
+
+      if (thread_id == INVALID_THREAD_ID)
+         continue;
+
+      if (m_samples.count(thread_id) && !m_samples[thread_id]->history.empty())
+      {
+         cpi = arithmetic_mean(m_samples[thread_id]->history) * period;
+
+         SubsecondTime min_cpi = period / m_dispatch_width;
+         if (cpi < min_cpi)
+            cpi = min_cpi; // max. m_dispatch_width IPC
+         else if (cpi > period * 100)
+            cpi = period * 100; // min. .01 IPC
+
+         if (m_resample_on_dvfs && period != m_core_periods[core_id])
+            resample = true;
+      }
+      else
+      {
+         // A thread that arrived or started since the last detailed interval: assume one-IPC until it is sampled
+         cpi = period;
+         resample = true;
+      }
+
+      core->getPerformanceModel()->getFastforwardPerformanceModel()->setCurrentCPI(cpi);
+   }
+
+   return resample;
+}
+
+void
+OpenSystemSampling::callbackDetailed(SubsecondTime time)
+{
+   if (!m_started)
+   {
+      m_sampling_manager->resetCoreHistoricCPIs();
+      startInterval();
+      m_periodic_last = time;
+      m_started = true;
+   }
+   else if (time > m_periodic_last + m_detailed_interval)
+   {
+      m_time_detailed += time - m_periodic_last;
+      collectSamples();
+
+      startInterval();
+      updateFastForwardCPIs();
+
+      m_fastforward_time_remaining = m_fastforward_interval;
+      m_warmup_time_remaining = m_warmup_interval;
+      bool done = stepFastForward(time);
+      LOG_ASSERT_ERROR(done == false, "No fastforwarding to be done");
+      m_periodic_last = time;
+   }
+}
+
+bool
+OpenSystemSampling::stepFastForward(SubsecondTime time)
+{
+   if (m_fastforward_time_remaining > SubsecondTime::Zero())
+   {
+      SubsecondTime time_to_fastforward = std::min(m_fastforward_time_remaining, m_fastforward_sync_interval);
+      m_fastforward_time_remaining -= time_to_fastforward;
+      m_sampling_manager->enableFastForward(time + time_to_fastforward, false, m_detailed_sync);
+      return false;
+   }
+   else if (m_warmup_time_remaining > SubsecondTime::Zero())
+   {
+      SubsecondTime time_to_warmup = std::min(m_warmup_time_remaining, m_fastforward_sync_interval);
+      m_warmup_time_remaining -= time_to_warmup;
+      m_sampling_manager->enableFastForward(time + time_to_warmup, true, m_detailed_sync);
+      return false;
+   }
+   else
+   {
+      return true;
+   }
+}
+
+void
+OpenSystemSampling::callbackFastForward(SubsecondTime time, bool in_warmup)
+{
+   if (in_warmup)
+      m_time_warmup += time - m_periodic_last;
+   else
+      m_time_fastforward += time - m_periodic_last;
+   m_periodic_last = time;
+
+   // Threads may have arrived, migrated or changed frequency during the last step
+   if (!in_warmup && updateFastForwardCPIs() && m_fastforward_time_remaining > SubsecondTime::Zero())
+   {
+      // Skip the rest of the fast-forward interval, but still warm up before sampling the new configuration
+      m_fastforward_time_remaining = SubsecondTime::Zero();
+      ++m_num_resamples;
+   }
+
+   bool done = stepFastForward(time);
+   if (done)
+   {
+      m_sampling_manager->resetCoreHistoricCPIs();
+      m_sampling_manager->disableFastForward();
+      startInterval();
+   }
+}
+
+void
+OpenSystemSampling::writeReport() const
+{
+   FILE *fp = fopen(Sim()->getConfig()->formatOutputFileName("sim.sampling").c_str(), "w");
+   if (!fp)
+      return;
+
+   SubsecondTime total = m_time_detailed + m_time_fastforward + m_time_warmup;
+   fprintf(fp, "detailed %" PRIu64 " ns, fast-forward %" PRIu64 " ns, warmup %" PRIu64 " ns (%.1f%% detailed), %" PRIu64 " early resamples\n",
+      m_time_detailed.getNS(), m_time_fastforward.getNS(), m_time_warmup.getNS(),
+      total > SubsecondTime::Zero() ? 100. * m_time_detailed.getFS() / total.getFS() : 0., m_num_resamples);
+   fprintf(fp, "thread\tsamples\tipc\tci95\n");
+
+   for(std::unordered_map<thread_id_t, ThreadSamples*>::const_iterator it = m_samples.begin(); it != m_samples.end(); ++it)
+   {
+      const ThreadSamples *samples = it->second;
+      double mean = samples->sum / samples->count;
+      if (samples->count > 1)
+      {
+         // Normal approximation of the 95% confidence interval on the mean IPC over all detailed intervals
+         double variance = std::max(0., (samples->sum_squares - samples->count * mean * mean) / (samples->count - 1));
+         fprintf(fp, "%d\t%" PRIu64 "\t%.4f\t%.4f\n", it->first, samples->count, mean, 1.96 * sqrt(variance / samples->count));
+      }
+      else
+         fprintf(fp, "%d\t%" PRIu64 "\t%.4f\t-\n", it->first, samples->count, mean);
+   }
+
+   fclose(fp);
+}
@@ -0,0 +1,66 @@
+#ifndef __OPEN_SYSTEM_SAMPLING
+#define __OPEN_SYSTEM_SAMPLING
+
+#include "fixed_types.h"
+#include "sampling_algorithm.h"
+#include "circular_queue.h"
+
+#include <vector>
+#include <unordered_map>
+
+// Periodic sampling for open systems (SchedulerOpen), where tasks arrive, migrate and change frequency over time.
+// CPIs measured in detailed intervals are kept per thread and in cycles, so while fast-forwarding they follow
+// a thread when it migrates and are rescaled when its core changes frequency. When a thread without any
+// detailed measurement starts running, fast-forwarding is cut short so it gets sampled in the next interval.
+class OpenSystemSampling : public SamplingAlgorithm
+{
+   protected:
+      class ThreadSamples
+      {
+         public:
+            ThreadSamples(UInt32 num_intervals) : history(num_intervals), count(0), sum(0), sum_squares(0) {}
+            CircularQueue<double> history;   // Most recent CPIs (in cycles), used while fast-forwarding
+            UInt64 count;                    // Statistics over all IPC samples, for the confidence interval
+            double sum, sum_squares;
+      };
+
+      SubsecondTime m_detailed_interval;
+      SubsecondTime m_fastforward_interval;
+      SubsecondTime m_fastforward_sync_interval;
+      SubsecondTime m_warmup_interval;
+      bool m_detailed_sync;
+      bool m_resample_on_dvfs;
+      UInt32 m_num_historic_cpi_intervals;
+      int m_dispatch_width;
+
+      bool m_started;
+      SubsecondTime m_periodic_last;
+      SubsecondTime m_fastforward_time_remaining;
+      SubsecondTime m_warmup_time_remaining;
+
+      // Thread and clock period of each core at the start of the current detailed or fast-forward interval
+      std::vector<thread_id_t> m_core_threads;
+      std::vector<SubsecondTime> m_core_periods;
+      std::unordered_map<thread_id_t, ThreadSamples*> m_samples;
+
+      SubsecondTime m_time_detailed;
+      SubsecondTime m_time_fastforward;
+      SubsecondTime m_time_warmup;
+      UInt64 m_num_resamples;
+
+      thread_id_t getCoreThread(core_id_t core_id) const;
+      void startInterval();
+      void collectSamples();
+      bool updateFastForwardCPIs();
+      bool stepFastForward(SubsecondTime time);
+      void writeReport() const;
+
+   public:
+      OpenSystemSampling(SamplingManager *sampling_manager);
+      virtual ~OpenSystemSampling();
+
+      virtual void callbackDetailed(SubsecondTime now);
+      virtual void callbackFastForward(SubsecondTime now, bool in_warmup);
+};
+
+#endif /* __OPEN_SYSTEM_SAMPLING */
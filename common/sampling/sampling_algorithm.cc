@@ -3,6 +3,7 @@
 #include "config.hpp"
 #include "log.h"
 #include "periodic_sampling.h"
+#include "open_system_sampling.h"
 
 SamplingAlgorithm*
 SamplingAlgorithm::create(SamplingManager *sampling_manager)
@@ -12,6 +13,10 @@ SamplingAlgorithm::create(SamplingManager *sampling_manager)
    {
       return new PeriodicSampling(sampling_manager);
    }
+   else if (sampling_algorithm == "open")
+   {
+      return new OpenSystemSampling(sampling_manager);
+   }
    else
    {
       LOG_PRINT_ERROR("Unexpected sampling algorithm '%s'", sampling_algorithm.c_str());
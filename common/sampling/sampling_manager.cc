@@ -27,7 +27,7 @@ SamplingManager::SamplingManager(void)
 
    m_uncoordinated = Sim()->getCfg()->getBool("sampling/uncoordinated");
 
-   LOG_ASSERT_ERROR(Sim()->getConfig()->getSimulationMode() == Config::PINTOOL, "Sampling is only supported in Pin mode");
+   LOG_ASSERT_ERROR(Sim()->getConfig()->getSimulationMode() == Config::PINTOOL || Sim()->getCfg()->getBool("traceinput/enabled"), "Sampling is only supported in Pin and trace-driven mode");
 
    Sim()->getHooksManager()->registerHook(HookType::HOOK_INSTR_COUNT, (HooksManager::HookCallbackFunc)SamplingManager::hook_instr_count, (UInt64)this);
    Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, (HooksManager::HookCallbackFunc)SamplingManager::hook_periodic, (UInt64)this);
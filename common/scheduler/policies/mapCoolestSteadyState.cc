@@ -0,0 +1,57 @@
+#include "mapCoolestSteadyState.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+MapCoolestSteadyState::MapCoolestSteadyState(const ThermalModel *thermalModel, const PerformanceCounters *performanceCounters, unsigned int coreRows, unsigned int coreColumns, double taskPower)
+	: thermalModel(thermalModel), performanceCounters(performanceCounters), coreRows(coreRows), coreColumns(coreColumns), taskPower(taskPower) {
+}
+
+/** map
+ * Place the threads one by one. For every free core, the steady state is predicted with the current core powers
+ * plus taskPower on the threads placed so far and on that core. All candidates are evaluated in one
+ * ThermalModel::getSteadyStates call, the core with the coolest hotspot wins.
+ */
+std::vector<int> MapCoolestSteadyState::map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCoresRO, const std::vector<bool> &activeCores) {
+	std::vector<bool> availableCores(availableCoresRO);
+	std::vector<int> cores;
+
+	std::vector<double> powers(coreRows * coreColumns);
+	for (unsigned int c = 0; c < coreRows * coreColumns; c++) {
+		powers.at(c) = activeCores.at(c) ? performanceCounters->getPowerOfCore(c) : thermalModel->getInactivePower();
+	}
+
+	for (; taskCoreRequirement > 0; taskCoreRequirement--) {
+		std::vector<int> candidates;
+		std::vector<std::vector<double>> candidatePowers;
+		for (unsigned int c = 0; c < coreRows * coreColumns; c++) {
+			if (availableCores.at(c)) {
+				candidates.push_back(c);
+				candidatePowers.push_back(powers);
+				candidatePowers.back().at(c) = taskPower;
+			}
+		}
+		if (candidates.empty()) {
+			// not enough free cores
+			std::vector<int> empty;
+			return empty;
+		}
+
+		std::vector<std::vector<float>> temperatures = thermalModel->getSteadyStates(candidatePowers);
+		int coolestCore = -1;
+		float coolestPeak = 0;
+		for (unsigned int i = 0; i < candidates.size(); i++) {
+			float peak = *std::max_element(temperatures.at(i).begin(), temperatures.at(i).end());
+			if ((coolestCore == -1) || (peak < coolestPeak)) {
+				coolestCore = candidates.at(i);
+				coolestPeak = peak;
+			}
+		}
+
+		std::cout << "[Scheduler][coolestSteadyState-map]: core " << coolestCore << " (predicted peak " << std::fixed << std::setprecision(1) << coolestPeak << ")" << std::endl;
+		cores.push_back(coolestCore);
+		availableCores.at(coolestCore) = false;
+		powers.at(coolestCore) = taskPower;
+	}
+	return cores;
+}
@@ -0,0 +1,26 @@
+/**
+ * This header implements a policy that maps each thread of a new task to the core
+ * that gives the lowest predicted steady-state peak temperature.
+ */
+
+#ifndef __MAP_COOLEST_STEADY_STATE_H
+#define __MAP_COOLEST_STEADY_STATE_H
+
+#include "mappingpolicy.h"
+#include "performance_counters.h"
+#include "thermalModel.h"
+
+class MapCoolestSteadyState : public MappingPolicy {
+public:
+    MapCoolestSteadyState(const ThermalModel *thermalModel, const PerformanceCounters *performanceCounters, unsigned int coreRows, unsigned int coreColumns, double taskPower);
+    virtual std::vector<int> map(String taskName, int taskCoreRequirement, const std::vector<bool> &availableCores, const std::vector<bool> &activeCores);
+
+private:
+    const ThermalModel *thermalModel;
+    const PerformanceCounters *performanceCounters;
+    unsigned int coreRows;
+    unsigned int coreColumns;
+    double taskPower;
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "policies/dvfsTSP.h"
 #include "policies/dvfsTestStaticPower.h"
 #include "policies/mapFirstUnused.h"
+#include "policies/mapCoolestSteadyState.h"
 #include "policies/dvfsOndemand.h"
 #include "policies/coldestCore.h"
 #include "policies/dvfsXCS.h"
@@ -296,6 +297,9 @@ void SchedulerOpen::initMappingPolicy(String policyName) {
 		"scheduler/open/migration/coldestCore/criticalTemperature");
 		mappingPolicy = new ColdestCore(performanceCounters, coreRows,
 		coreColumns, criticalTemperature);
+	} else if (policyName == "coolestSteadyState") {
+		double taskPower = Sim()->getCfg()->getFloat("scheduler/open/coolestSteadyState/task_power");
+		mappingPolicy = new MapCoolestSteadyState(thermalModel, performanceCounters, coreRows, coreColumns, taskPower);
 	} //else if (policyName ="XYZ") {... } //Place to instantiate a new mapping logic. Implementation is put in "policies" package.
 	else {
 		cout << "\n[Scheduler] [Error]: Unknown Mapping Algorithm" << endl;
@@ -1322,11 +1326,20 @@ void SchedulerOpen::executeMigrationPolicy(SubsecondTime time) {
 }
 
 
+/** isEpoch
+    Returns true if an epoch boundary was passed since the previous call of periodic.
+    In detailed mode periodic is called at every barrier quantum, but when sampling,
+    fast-forwarded intervals skip over many quanta at once.
+*/
+bool SchedulerOpen::isEpoch(SubsecondTime time, long epoch) {
+	return time.getNS() % epoch == 0 || time.getNS() / epoch != m_last_periodic.getNS() / epoch;
+}
+
 /** periodic
     This function is called periodically by Sniper at Interval of 100ns.
 */
 void SchedulerOpen::periodic(SubsecondTime time) {
-	if (time.getNS () % 1000000 == 0) { //Error Checking at every 1ms. Can be faster but will have overhead in simulation time.
+	if (isEpoch(time, 1000000)) { //Error Checking at every 1ms. Can be faster but will have overhead in simulation time.
 		cout << "\n[Scheduler]: Time " << formatTime(time) << " [Active Tasks =  " << numberOfActiveTasks () << " | Completed Tasks = " <<  numberOfTasksCompleted () << " | Queued Tasks = "  << numberOfTasksInQueue () << " | Non-Queued Tasks  = " <<  numberOfTasksWaitingToSchedule () <<  " | Free Cores = " << numberOfFreeCores () << " | Active Tasks Requirements = " << totalCoreRequirementsOfActiveTasks () << " ] \n" << endl;
 
 		// showtaskID(waitingTaskQ);
@@ -1344,13 +1357,13 @@ void SchedulerOpen::periodic(SubsecondTime time) {
 		}
 	}
 
-	if ((migrationPolicy != NULL) && (time.getNS() % migrationEpoch == 0)) {
+	if ((migrationPolicy != NULL) && isEpoch(time, migrationEpoch)) {
 		cout << "\n[Scheduler]: Migration invoked at " << formatTime(time) << endl;
 
 		executeMigrationPolicy(time);
 	}
 
-	if ((dvfsPolicy != NULL) && (time.getNS() % dvfsEpoch == 0)) {
+	if ((dvfsPolicy != NULL) && isEpoch(time, dvfsEpoch)) {
 		cout << "\n[Scheduler]: DVFS Control Loop invoked at " << formatTime(time) << endl;
 
 		executeDVFSPolicy();
@@ -1361,7 +1374,7 @@ void SchedulerOpen::periodic(SubsecondTime time) {
 		}
 	}
 
-	if (time.getNS () % mappingEpoch == 0) {
+	if (isEpoch(time, mappingEpoch)) {
 		
 		cout << "\n[Scheduler]: Scheduler Invoked at " << formatTime(time) << "\n" << endl;
 
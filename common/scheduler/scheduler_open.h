@@ -63,6 +63,7 @@ class SchedulerOpen : public SchedulerPinnedBase {
 		void migrateThread(thread_id_t thread_id, core_id_t core_id);
 
 		std::string formatTime(SubsecondTime time);
+		bool isEpoch(SubsecondTime time, long epoch);
 
 		core_id_t getNextCore(core_id_t core_first);
 		core_id_t getFreeCore(core_id_t core_first);
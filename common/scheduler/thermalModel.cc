@@ -1,9 +1,10 @@
 #include "thermalModel.h"
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 
 ThermalModel::ThermalModel(unsigned int coreRows, unsigned int coreColumns, const String thermalModelFilename, double ambientTemperature, double maxTemperature, double inactivePower, double tdp)
-    : ambientTemperature(ambientTemperature), maxTemperature(maxTemperature), inactivePower(inactivePower), tdp(tdp) {
+    : ambientTemperature(ambientTemperature), maxTemperature(maxTemperature), inactivePower(inactivePower), tdp(tdp), BInv(NULL), rank(0) {
     this->coreRows = coreRows;
     this->coreColumns = coreColumns;
 
@@ -11,6 +12,12 @@ ThermalModel::ThermalModel(unsigned int coreRows, unsigned int coreColumns, cons
     f.open(thermalModelFilename.c_str());
 
     unsigned int numberUnits = readValue<unsigned int>(f);
+    if (numberUnits == REDUCED_MODEL_MAGIC) {
+        readReducedModel(f, readValue<unsigned int>(f));
+        f.close();
+        return;
+    }
+
     unsigned int numberNodesAmbient = readValue<unsigned int>(f);
     unsigned int numberThermalNodes = readValue<unsigned int>(f);
 
@@ -33,12 +40,44 @@ ThermalModel::ThermalModel(unsigned int coreRows, unsigned int coreColumns, cons
         //height = readDouble(f);
     }
 
-    readDoubleMatrix(f, &BInv, numberThermalNodes, numberThermalNodes);
+    // only the resistances between the cores are used, the rows of the remaining nodes and the remaining file are not read
+    readDoubleMatrix(f, &BInv, numberUnits, numberUnits, numberThermalNodes - numberUnits);
 
-    // remaining file is not read
     f.close();
 }
 
+/** readReducedModel
+ * Read a reduced-order model as written by hotspot/hotrom: the slowest thermal modes of the cores
+ * with their time constants, and a sparse static correction that stands in for the remaining modes.
+ * Memory and the cost of applying the model grow with cores * rank instead of cores^2.
+ */
+void ThermalModel::readReducedModel(std::ifstream &file, unsigned int numberUnits) {
+    if (numberUnits != coreRows * coreColumns) {
+        std::cout << "Assertion error in thermal model file: numberUnits != coreRows * coreColumns" << std::endl;
+		exit (1);
+    }
+    rank = readValue<unsigned int>(file);
+    if (rank == 0) {
+        std::cout << "Assertion error in thermal model file: rank == 0" << std::endl;
+		exit (1);
+    }
+
+    for (unsigned int u = 0; u < numberUnits; u++) {
+        std::string unitName = readLine(file);
+    }
+
+    readVector(file, timeConstants, rank);
+    readVector(file, modes, numberUnits * rank);
+    unsigned int numberCorrections = readValue<unsigned int>(file);
+    readVector(file, correctionStart, numberUnits + 1);
+    readVector(file, correctionColumn, numberCorrections);
+    readVector(file, correctionValue, numberCorrections);
+    if (correctionStart.at(numberUnits) != numberCorrections) {
+        std::cout << "Assertion error in thermal model file: inconsistent static correction" << std::endl;
+		exit (1);
+    }
+}
+
 template<typename T>
 T ThermalModel::readValue(std::ifstream &file) const {
     T value;
@@ -62,16 +101,108 @@ std::string ThermalModel::readLine(std::ifstream &file) const {
     return value;
 }
 
-void ThermalModel::readDoubleMatrix(std::ifstream &file, double ***matrix, unsigned int rows, unsigned int columns) const {
+void ThermalModel::readDoubleMatrix(std::ifstream &file, double ***matrix, unsigned int rows, unsigned int columns, unsigned int skipColumns) const {
     (*matrix) = new double*[rows];
     for (unsigned int r = 0; r < rows; r++) {
         (*matrix)[r] = new double[columns];
         for (unsigned int c = 0; c < columns; c++) {
             (*matrix)[r][c] = readValue<double>(file);
         }
+        file.seekg(skipColumns * sizeof(double), std::ios::cur);
+    }
+}
+
+template<typename T>
+void ThermalModel::readVector(std::ifstream &file, std::vector<T> &vector, unsigned int size) const {
+    vector.resize(size);
+    for (unsigned int i = 0; i < size; i++) {
+        vector.at(i) = readValue<T>(file);
     }
 }
 
+/** resistance
+ * Return the temperature rise of core per watt dissipated in core i.
+ */
+double ThermalModel::resistance(unsigned int core, unsigned int i) const {
+    if (rank == 0) {
+        return BInv[core][i];
+    }
+
+    double r = 0;
+    for (unsigned int k = 0; k < rank; k++) {
+        r += modes[core * rank + k] * timeConstants[k] * modes[i * rank + k];
+    }
+    std::vector<unsigned int>::const_iterator begin = correctionColumn.begin() + correctionStart[core];
+    std::vector<unsigned int>::const_iterator end = correctionColumn.begin() + correctionStart[core + 1];
+    std::vector<unsigned int>::const_iterator it = std::lower_bound(begin, end, i);
+    if (it != end && *it == i) {
+        r += correctionValue[it - correctionColumn.begin()];
+    }
+    return r;
+}
+
+std::vector<double> ThermalModel::resistanceRow(unsigned int core) const {
+    unsigned int numberCores = coreRows * coreColumns;
+    std::vector<double> row(numberCores);
+    if (rank == 0) {
+        for (unsigned int i = 0; i < numberCores; i++) {
+            row.at(i) = BInv[core][i];
+        }
+        return row;
+    }
+
+    std::vector<double> weights(rank);
+    for (unsigned int k = 0; k < rank; k++) {
+        weights[k] = modes[core * rank + k] * timeConstants[k];
+    }
+    for (unsigned int i = 0; i < numberCores; i++) {
+        for (unsigned int k = 0; k < rank; k++) {
+            row[i] += modes[i * rank + k] * weights[k];
+        }
+    }
+    for (unsigned int e = correctionStart[core]; e < correctionStart[core + 1]; e++) {
+        row[correctionColumn[e]] += correctionValue[e];
+    }
+    return row;
+}
+
+/** applyResistance
+ * Return the temperature rise of every core for the given per-core powers.
+ */
+std::vector<double> ThermalModel::applyResistance(const std::vector<double> &powers) const {
+    unsigned int numberCores = coreRows * coreColumns;
+    std::vector<double> rise(numberCores, 0);
+    if (rank == 0) {
+        for (unsigned int core = 0; core < numberCores; core++) {
+            for (unsigned int i = 0; i < numberCores; i++) {
+                rise[core] += powers.at(i) * BInv[core][i];
+            }
+        }
+        return rise;
+    }
+
+    // steady state of the slow modes
+    std::vector<double> modal(rank, 0);
+    for (unsigned int i = 0; i < numberCores; i++) {
+        for (unsigned int k = 0; k < rank; k++) {
+            modal[k] += modes[i * rank + k] * powers.at(i);
+        }
+    }
+    for (unsigned int k = 0; k < rank; k++) {
+        modal[k] *= timeConstants[k];
+    }
+
+    for (unsigned int core = 0; core < numberCores; core++) {
+        for (unsigned int k = 0; k < rank; k++) {
+            rise[core] += modes[core * rank + k] * modal[k];
+        }
+        for (unsigned int e = correctionStart[core]; e < correctionStart[core + 1]; e++) {
+            rise[core] += correctionValue[e] * powers.at(correctionColumn[e]);
+        }
+    }
+    return rise;
+}
+
 double ThermalModel::tsp(const std::vector<bool> &activeCores) const {
     std::vector<double> powerOfInactiveCores(activeCores.size(), inactivePower);
 
@@ -86,28 +217,25 @@ double ThermalModel::tsp(const std::vector<bool> &activeCores, const std::vector
 
     int amtActiveCores = 0;
     double idlePower = 0;
+    std::vector<double> active(activeCores.size(), 0);
+    std::vector<double> inactivePowers(activeCores.size(), 0);
     for (unsigned int i = 0; i < activeCores.size(); i++) {
         if (activeCores.at(i)) {
             amtActiveCores++;
+            active.at(i) = 1;
         } else {
             idlePower += powerOfInactiveCores.at(i);
+            inactivePowers.at(i) = powerOfInactiveCores.at(i);
         }
     }
 
     double minTSP = (tdp - idlePower) / amtActiveCores; // TDP constraint
 
     if (amtActiveCores > 0) {
+        std::vector<double> activeSums = applyResistance(active);
+        std::vector<double> inactiveSums = applyResistance(inactivePowers);
         for (unsigned int core = 0; core < activeCores.size(); core++) {
-            double activeSum = 0;
-            double inactiveSum = 0;
-            for (unsigned int i = 0; i < activeCores.size(); i++) {
-                if (activeCores.at(i)) {
-                    activeSum += BInv[core][i];
-                } else {
-                    inactiveSum += powerOfInactiveCores.at(i) * BInv[core][i];
-                }
-            }
-            double coreSafePower = (maxTemperature - ambientTemperature - inactiveSum) / activeSum;
+            double coreSafePower = (maxTemperature - ambientTemperature - inactiveSums.at(core)) / activeSums.at(core);
             minTSP = std::min(minTSP, coreSafePower);
         }
     }
@@ -128,21 +256,27 @@ std::vector<double> ThermalModel::tspForManyCandidates(const std::vector<bool> &
     std::vector<double> tsps(candidates.size(), tdpConstraint);
 
     if (amtActiveCores > 0) {
-        for (unsigned int core = 0; core < activeCores.size(); core++) {
-            double activeSum = 0;
-            double inactiveSum = 0;
-            for (unsigned int i = 0; i < activeCores.size(); i++) {
-                if (activeCores.at(i)) {
-                    activeSum += BInv[core][i];
-                } else {
-                    inactiveSum += BInv[core][i];
-                }
+        std::vector<double> active(activeCores.size(), 0);
+        std::vector<double> inactive(activeCores.size(), 0);
+        for (unsigned int i = 0; i < activeCores.size(); i++) {
+            if (activeCores.at(i)) {
+                active.at(i) = 1;
+            } else {
+                inactive.at(i) = 1;
             }
+        }
+        std::vector<double> activeSums = applyResistance(active);
+        std::vector<double> inactiveSums = applyResistance(inactive);
+
+        for (unsigned int core = 0; core < activeCores.size(); core++) {
+            double activeSum = activeSums.at(core);
+            double inactiveSum = inactiveSums.at(core);
 
             for (unsigned int candidateIdx = 0; candidateIdx < candidates.size(); candidateIdx++) {
                 int candidate = candidates.at(candidateIdx);
-                double candActiveSum = activeSum + BInv[core][candidate];
-                double candInactiveSum = inactiveSum - BInv[core][candidate];
+                double candidateResistance = resistance(core, candidate);
+                double candActiveSum = activeSum + candidateResistance;
+                double candInactiveSum = inactiveSum - candidateResistance;
                 double coreSafePower = (maxTemperature - ambientTemperature - inactivePower * candInactiveSum) / candActiveSum;
                 tsps.at(candidateIdx) = std::min(tsps.at(candidateIdx), coreSafePower);
             }
@@ -158,10 +292,7 @@ double ThermalModel::worstCaseTSP(int amtActiveCores) const {
 
     if (amtActiveCores > 0) {
         for (unsigned int core = 0; core < (unsigned int)(coreRows * coreColumns); core++) {
-            std::vector<double> BInvRow(coreRows * coreColumns);
-            for (unsigned int i = 0; i < (unsigned int)(coreRows * coreColumns); i++) {
-                BInvRow.at(i) = BInv[core][i];
-            }
+            std::vector<double> BInvRow = resistanceRow(core);
             std::sort(BInvRow.begin(), BInvRow.end(), std::greater<double>()); // sort descending
 
             double activeSum = 0;
@@ -230,7 +361,7 @@ std::vector<double> ThermalModel::powerBudgetMaxSteadyState(const std::vector<bo
     for (unsigned int i = 0; i < activeIndices.size(); i++) {
         std::vector<float> row;
         for (unsigned int j = 0; j < activeIndices.size(); j++) {
-            row.push_back(BInv[activeIndices.at(i)][activeIndices.at(j)]);
+            row.push_back(resistance(activeIndices.at(i), activeIndices.at(j)));
         }
         BInvTrunc.push_back(row);
     }
@@ -246,12 +377,101 @@ std::vector<double> ThermalModel::powerBudgetMaxSteadyState(const std::vector<bo
 }
 
 std::vector<float> ThermalModel::getSteadyState(const std::vector<double> &powers) const {
+    std::vector<double> rise = applyResistance(powers);
     std::vector<float> temperatures(coreRows * coreColumns);
     for (unsigned int core = 0; core < (unsigned int)(coreRows * coreColumns); core++) {
-        temperatures.at(core) = ambientTemperature;
-        for (unsigned int i = 0; i < (unsigned int)(coreRows * coreColumns); i++) {
-            temperatures.at(core) += powers.at(i) * BInv[core][i];
+        temperatures.at(core) = ambientTemperature + rise.at(core);
+    }
+    return temperatures;
+}
+
+/** getSteadyStates
+ * Return the steady-state temperatures for many candidate power vectors (e.g., candidate mappings) at once.
+ * All candidates are evaluated together as a single matrix-matrix product with BInv.
+ */
+std::vector<std::vector<float>> ThermalModel::getSteadyStates(const std::vector<std::vector<double>> &powers) const {
+    unsigned int numberCores = coreRows * coreColumns;
+    unsigned int numberCandidates = powers.size();
+
+    if (rank > 0) {
+        // the reduced-order model is cheapest to apply per candidate
+        std::vector<std::vector<float>> temperatures;
+        for (unsigned int candidate = 0; candidate < numberCandidates; candidate++) {
+            temperatures.push_back(getSteadyState(powers.at(candidate)));
+        }
+        return temperatures;
+    }
+
+    // candidate powers as a cores x candidates matrix
+    std::vector<double> candidatePowers(numberCores * numberCandidates);
+    for (unsigned int candidate = 0; candidate < numberCandidates; candidate++) {
+        if (powers.at(candidate).size() != numberCores) {
+            std::cout << "\n[Scheduler][ThermalModel][Error]: Invalid power vector size: " << powers.at(candidate).size() << ", expected " << numberCores << "cores." << std::endl;
+            exit (1);
+        }
+        for (unsigned int i = 0; i < numberCores; i++) {
+            candidatePowers.at(i * numberCandidates + candidate) = powers.at(candidate).at(i);
+        }
+    }
+
+    // temperatures = ambient + BInv * candidatePowers
+    std::vector<double> candidateTemperatures(numberCores * numberCandidates, ambientTemperature);
+    for (unsigned int core = 0; core < numberCores; core++) {
+        double *t = candidateTemperatures.data() + core * numberCandidates;
+        for (unsigned int i = 0; i < numberCores; i++) {
+            double b = BInv[core][i];
+            const double *p = candidatePowers.data() + i * numberCandidates;
+            for (unsigned int candidate = 0; candidate < numberCandidates; candidate++) {
+                t[candidate] += b * p[candidate];
+            }
+        }
+    }
+
+    std::vector<std::vector<float>> temperatures(numberCandidates, std::vector<float>(numberCores));
+    for (unsigned int candidate = 0; candidate < numberCandidates; candidate++) {
+        for (unsigned int core = 0; core < numberCores; core++) {
+            temperatures.at(candidate).at(core) = candidateTemperatures.at(core * numberCandidates + candidate);
+        }
+    }
+    return temperatures;
+}
+
+/** predictTransient
+ * Advance the core temperatures by the given time under constant powers, using the thermal modes of a reduced-order model.
+ * modalState holds the state of the slow modes between calls, an empty state is the chip at ambient temperature.
+ * The fast modes that were dropped from the model respond instantaneously through the static correction.
+ */
+std::vector<float> ThermalModel::predictTransient(std::vector<double> &modalState, const std::vector<double> &powers, double seconds) const {
+    if (rank == 0) {
+        std::cout << "\n[Scheduler][ThermalModel][Error]: Transient prediction requires a reduced-order thermal model (hotspot/hotrom)." << std::endl;
+        exit (1);
+    }
+    unsigned int numberCores = coreRows * coreColumns;
+    if (modalState.empty()) {
+        modalState.assign(rank, 0);
+    }
+
+    std::vector<double> modalPower(rank, 0);
+    for (unsigned int i = 0; i < numberCores; i++) {
+        for (unsigned int k = 0; k < rank; k++) {
+            modalPower[k] += modes[i * rank + k] * powers.at(i);
+        }
+    }
+    for (unsigned int k = 0; k < rank; k++) {
+        double decay = exp(-seconds / timeConstants[k]);
+        modalState.at(k) = decay * modalState.at(k) + (1 - decay) * timeConstants[k] * modalPower[k];
+    }
+
+    std::vector<float> temperatures(numberCores);
+    for (unsigned int core = 0; core < numberCores; core++) {
+        double t = ambientTemperature;
+        for (unsigned int k = 0; k < rank; k++) {
+            t += modes[core * rank + k] * modalState.at(k);
+        }
+        for (unsigned int e = correctionStart[core]; e < correctionStart[core + 1]; e++) {
+            t += correctionValue[e] * powers.at(correctionColumn[e]);
         }
+        temperatures.at(core) = t;
     }
     return temperatures;
 }
@@ -17,9 +17,13 @@ public:
     double worstCaseTSP(int amtActiveCores) const;
     std::vector<double> powerBudgetMaxSteadyState(const std::vector<bool> &activeCores) const;
     std::vector<float> getSteadyState(const std::vector<double> &powers) const;
+    std::vector<std::vector<float>> getSteadyStates(const std::vector<std::vector<double>> &powers) const;
 
     float getInactivePower() const { return inactivePower; }
 
+    bool isReduced() const { return rank > 0; }
+    std::vector<float> predictTransient(std::vector<double> &modalState, const std::vector<double> &powers, double seconds) const;
+
 private:
     double ambientTemperature;
     double maxTemperature;
@@ -27,12 +31,29 @@ private:
     double tdp;
     template<typename T> T readValue(std::ifstream &file) const;
     std::string readLine(std::ifstream &file) const;
-    void readDoubleMatrix(std::ifstream &file, double ***matrix, unsigned int rows, unsigned int columns) const;
+    void readDoubleMatrix(std::ifstream &file, double ***matrix, unsigned int rows, unsigned int columns, unsigned int skipColumns = 0) const;
+    template<typename T> void readVector(std::ifstream &file, std::vector<T> &vector, unsigned int size) const;
+    void readReducedModel(std::ifstream &file, unsigned int numberUnits);
+
+    double resistance(unsigned int core, unsigned int i) const;
+    std::vector<double> resistanceRow(unsigned int core) const;
+    std::vector<double> applyResistance(const std::vector<double> &powers) const;
 
     unsigned int coreRows;
     unsigned int coreColumns;
 
+    // dense model: thermal resistances between the cores (the core block of the full BInv)
     double **BInv;
+
+    // reduced-order model from hotspot/hotrom: the resistances are
+    // modes * diag(timeConstants) * modes^T + a sparse static correction
+    static const unsigned int REDUCED_MODEL_MAGIC = 0x4d4f5254;
+    unsigned int rank;
+    std::vector<double> timeConstants;
+    std::vector<double> modes; // cores x rank
+    std::vector<unsigned int> correctionStart; // compressed sparse rows
+    std::vector<unsigned int> correctionColumn;
+    std::vector<double> correctionValue;
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include "simulator.h"
 #include "magic_server.h"
 #include "sim_api.h"
+#include "clock_skew_minimization_object.h"
 
 static PyObject *
 setROI(PyObject *self, PyObject *args)
@@ -67,11 +68,25 @@ simulatorAbort(PyObject *self, PyObject *args)
    exit(0);
 }
 
+static PyObject *
+addPeriodicInterval(PyObject *self, PyObject *args)
+{
+   long long int interval = 0;
+
+   if (!PyArg_ParseTuple(args, "L", &interval))
+      return NULL;
+
+   Sim()->getClockSkewMinimizationServer()->addPeriodicInterval(SubsecondTime::FS(interval));
+
+   Py_RETURN_NONE;
+}
+
 static PyMethodDef PyControlMethods[] = {
    { "set_roi", setROI, METH_VARARGS, "Set whether or not we are in the ROI" },
    { "set_instrumentation_mode", setInstrumentationMode, METH_VARARGS, "Set instrumentation mode" },
    { "set_progress", setProgress, METH_VARARGS, "Set simulation progress indicator (0..1)" },
    { "abort", simulatorAbort, METH_VARARGS, "Stop simulation now" },
+   { "add_periodic_interval", addPeriodicInterval, METH_VARARGS, "Request barriers at least at every multiple of this interval (fs)" },
    { NULL, NULL, 0, NULL } /* Sentinel */
 };
 
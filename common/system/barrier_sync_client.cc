@@ -42,5 +42,9 @@ BarrierSyncClient::synchronize(SubsecondTime time, bool ignore_time, bool abort_
       m_barrier_interval = Sim()->getClockSkewMinimizationServer()->getBarrierInterval();
       // Update 'm_next_sync_time'
       m_next_sync_time = ((curr_elapsed_time / m_barrier_interval) * m_barrier_interval) + m_barrier_interval;
+      // An adaptive quantum does not keep barriers aligned to multiples of the interval, do not run past the next one
+      SubsecondTime next_barrier_time = Sim()->getClockSkewMinimizationServer()->getGlobalTime(true);
+      if (next_barrier_time > curr_elapsed_time && next_barrier_time < m_next_sync_time)
+         m_next_sync_time = next_barrier_time;
    }
 }
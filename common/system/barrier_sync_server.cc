@@ -14,13 +14,17 @@
 #include "circular_log.h"
 
 #include <algorithm>
+#include <cmath>
 
 BarrierSyncServer::BarrierSyncServer()
    : m_local_clock_list(Sim()->getConfig()->getApplicationCores(), SubsecondTime::Zero())
    , m_barrier_acquire_list(Sim()->getConfig()->getApplicationCores(), false)
    , m_core_cond(Sim()->getConfig()->getApplicationCores(), NULL)
    , m_core_group(Sim()->getConfig()->getApplicationCores(), INVALID_CORE_ID)
+   , m_core_siblings(Sim()->getConfig()->getApplicationCores())
    , m_core_thread(Sim()->getConfig()->getApplicationCores(), INVALID_THREAD_ID)
+   , m_interactions(0)
+   , m_cpufreq_changed(0)
    , m_global_time(SubsecondTime::Zero())
    , m_fastforward(false)
    , m_disable(false)
@@ -34,6 +38,24 @@ BarrierSyncServer::BarrierSyncServer()
       LOG_PRINT_ERROR("Error Reading 'clock_skew_minimization/barrier/quantum' from the config file");
    }
 
+   m_group_size = Sim()->getCfg()->getInt("clock_skew_minimization/barrier/group_size");
+   if (m_group_size == 0)
+      m_group_size = std::max(1, (int)ceil(sqrt(Sim()->getConfig()->getApplicationCores())));
+   m_group_reached.resize((Sim()->getConfig()->getApplicationCores() + m_group_size - 1) / m_group_size, false);
+
+   m_adaptive = Sim()->getCfg()->getBool("clock_skew_minimization/barrier/adaptive/enabled");
+   m_min_interval = SubsecondTime::NS() * (UInt64) Sim()->getCfg()->getInt("clock_skew_minimization/barrier/adaptive/min_quantum");
+   m_max_interval = SubsecondTime::NS() * (UInt64) Sim()->getCfg()->getInt("clock_skew_minimization/barrier/adaptive/max_quantum");
+   m_skew_budget = Sim()->getCfg()->getInt("clock_skew_minimization/barrier/adaptive/skew_budget");
+   if (m_adaptive)
+   {
+      LOG_ASSERT_ERROR(m_min_interval > SubsecondTime::Zero() && m_min_interval <= m_barrier_interval && m_barrier_interval <= m_max_interval,
+                       "Expected 0 < min_quantum <= quantum <= max_quantum for the adaptive barrier");
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_THREAD_RESUME, BarrierSyncServer::hookThreadResume, (UInt64)this);
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_CPUFREQ_CHANGE, BarrierSyncServer::hookCpufreqChange, (UInt64)this);
+      registerStatsMetric("barrier", 0, "quantum", &m_barrier_interval);
+   }
+
    for(core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); ++core_id)
       m_core_cond[core_id] = new ConditionVariable();
 
@@ -93,7 +115,7 @@ BarrierSyncServer::synchronize(core_id_t core_id, SubsecondTime time)
    m_core_thread[master_core_id] = thread_me;
 
    bool mustWait = true;
-   if (isBarrierReached())
+   if (isBarrierReached(master_core_id))
       mustWait = barrierRelease(thread_me);
 
    if (mustWait)
@@ -170,13 +192,10 @@ BarrierSyncServer::isCoreRunning(core_id_t core_id, bool siblings)
 
    if (siblings && !m_fastforward)
    {
-      for (core_id_t sibling_core_id = 0; sibling_core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); sibling_core_id++)
+      for (std::vector<core_id_t>::const_iterator it = m_core_siblings[core_id].begin(); it != m_core_siblings[core_id].end(); ++it)
       {
-         if (m_core_group[sibling_core_id] == core_id)
-         {
-            if (isCoreRunning(sibling_core_id, false))
-               return true;
-         }
+         if (isCoreRunning(*it, false))
+            return true;
       }
    }
 
@@ -190,13 +209,13 @@ BarrierSyncServer::advance()
 }
 
 bool
-BarrierSyncServer::isBarrierReached()
+BarrierSyncServer::isGroupReached(UInt32 group, bool &single_core_barrier_reached)
 {
-   bool single_core_barrier_reached = false;
+   core_id_t first = group * m_group_size;
+   core_id_t last = std::min(first + (core_id_t)m_group_size, (core_id_t)Sim()->getConfig()->getApplicationCores());
 
-   // Check if all cores have reached the barrier
-   // All least one core must have (sync_time > m_next_barrier_time)
-   for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+   // Check if all cores in this group have reached the barrier
+   for (core_id_t core_id = first; core_id < last; core_id++)
    {
       // In fastforward mode, it's enough that a core is waiting. In detailed mode, it needs to have advanced up to the predefined barrier time
       if (m_fastforward)
@@ -233,7 +252,54 @@ BarrierSyncServer::isBarrierReached()
       }
    }
 
-   return single_core_barrier_reached;
+   return true;
+}
+
+void
+BarrierSyncServer::resetGroups()
+{
+   std::fill(m_group_reached.begin(), m_group_reached.end(), false);
+}
+
+bool
+BarrierSyncServer::isBarrierReached(core_id_t core_id)
+{
+   bool single_core_barrier_reached = false;
+
+   if (core_id != INVALID_CORE_ID && !m_fastforward)
+   {
+      // A core entered the barrier: only its own group can have changed state.
+      // Groups that were not yet reached are checked again, as their cores may since have stopped running,
+      // up to the first one that still has to wait. Reached groups are trusted until the full check below.
+      UInt32 group = core_id / m_group_size;
+      m_group_reached[group] = isGroupReached(group, single_core_barrier_reached);
+      if (!m_group_reached[group])
+         return false;
+
+      for (UInt32 g = 0; g < m_group_reached.size(); g++)
+      {
+         if (!m_group_reached[g])
+         {
+            m_group_reached[g] = isGroupReached(g, single_core_barrier_reached);
+            if (!m_group_reached[g])
+               return false;
+         }
+      }
+   }
+
+   // All groups appear to have reached the barrier (or we were called without a core having entered it):
+   // check all of them, a core in a group that was reached before may have been woken up since
+   bool barrier_reached = true;
+   single_core_barrier_reached = false;
+   for (UInt32 g = 0; g < m_group_reached.size(); g++)
+   {
+      m_group_reached[g] = isGroupReached(g, single_core_barrier_reached);
+      if (!m_group_reached[g])
+         barrier_reached = false;
+   }
+
+   // All least one core must have (sync_time > m_next_barrier_time)
+   return barrier_reached && single_core_barrier_reached;
 }
 
 bool
@@ -283,7 +349,7 @@ BarrierSyncServer::barrierRelease(thread_id_t caller_id, bool continue_until_rel
       if (m_disable)
          return false;
 
-      m_next_barrier_time += m_barrier_interval;
+      m_next_barrier_time = computeNextBarrierTime();
       LOG_PRINT("m_next_barrier_time updated to (%s)", itostr(m_next_barrier_time).c_str());
 
       for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
@@ -315,12 +381,54 @@ BarrierSyncServer::barrierRelease(thread_id_t caller_id, bool continue_until_rel
    // To avoid overwhelming the OS scheduler, we only release N threads at a time (N ~= host cores).
    // Once a thread is done (stops executing because it completed the next barrier quantum, or due to thread stall),
    // one more thread is released so we always have at most N running threads.
+   resetGroups();
+
    std::random_shuffle(m_to_release.begin(), m_to_release.end());
    doRelease(m_fastforward ? -1 : Sim()->getConfig()->getNumHostCores());
 
    return must_wait;
 }
 
+SubsecondTime
+BarrierSyncServer::computeNextBarrierTime()
+{
+   if (!m_adaptive || m_fastforward)
+      return m_next_barrier_time + m_barrier_interval;
+
+   UInt64 interactions = __sync_lock_test_and_set(&m_interactions, 0);
+   bool cpufreq_changed = __sync_lock_test_and_set(&m_cpufreq_changed, 0);
+   if (cpufreq_changed)
+      m_barrier_interval = m_min_interval;
+   else if (interactions > m_skew_budget)
+      m_barrier_interval = std::max(m_min_interval, m_barrier_interval / 2);
+   else if (2 * interactions <= m_skew_budget)
+      m_barrier_interval = std::min(m_max_interval, m_barrier_interval + m_barrier_interval / 4);
+
+   SubsecondTime next_barrier_time = m_next_barrier_time + m_barrier_interval;
+
+   // Wake up sleeping threads on time
+   SubsecondTime timeout = Sim()->getSyscallServer()->getNextTimeout(m_next_barrier_time);
+   if (timeout > m_next_barrier_time && timeout < next_barrier_time)
+      next_barrier_time = timeout;
+
+   // Call periodic callbacks on time
+   for (std::vector<SubsecondTime>::const_iterator it = m_periodic_intervals.begin(); it != m_periodic_intervals.end(); ++it)
+   {
+      SubsecondTime deadline = m_next_barrier_time - m_next_barrier_time % *it + *it;
+      if (deadline < next_barrier_time)
+         next_barrier_time = deadline;
+   }
+
+   return next_barrier_time;
+}
+
+void
+BarrierSyncServer::addPeriodicInterval(SubsecondTime interval)
+{
+   if (m_adaptive)
+      m_periodic_intervals.push_back(interval);
+}
+
 void
 BarrierSyncServer::doRelease(int n)
 {
@@ -366,7 +474,16 @@ BarrierSyncServer::setGroup(core_id_t core_id, core_id_t master_core_id)
    if (master_core_id != INVALID_CORE_ID)
       LOG_ASSERT_ERROR(m_barrier_acquire_list[core_id] == false, "Core(%d) is in the barrier, cannot set participate to false", core_id);
 
+   if (m_core_group[core_id] != INVALID_CORE_ID)
+   {
+      std::vector<core_id_t> &siblings = m_core_siblings[m_core_group[core_id]];
+      siblings.erase(std::find(siblings.begin(), siblings.end(), core_id));
+   }
+   if (master_core_id != INVALID_CORE_ID)
+      m_core_siblings[master_core_id].push_back(core_id);
+
    m_core_group[core_id] = master_core_id;
+   resetGroups();
 }
 
 void
@@ -375,6 +492,7 @@ BarrierSyncServer::setFastForward(bool fastforward, SubsecondTime next_barrier_t
    if (m_fastforward != fastforward)
       CLOG("barrier", "FastForward %d > %d", m_fastforward, fastforward);
    m_fastforward = fastforward;
+   resetGroups();
    if (next_barrier_time != SubsecondTime::MaxTime())
    {
       m_next_barrier_time = std::max(m_next_barrier_time, next_barrier_time);
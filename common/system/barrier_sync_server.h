@@ -19,12 +19,32 @@ class BarrierSyncServer : public ClockSkewMinimizationServer
       std::vector<ConditionVariable*> m_core_cond;
       std::vector<core_id_t> m_to_release;
       std::vector<core_id_t> m_core_group;
+      std::vector<std::vector<core_id_t> > m_core_siblings;
       std::vector<thread_id_t> m_core_thread;
+
+      // Cores are split into groups of m_group_size that are checked independently, so a core entering
+      // the barrier only looks at its own group and at groups that have not yet reached the barrier.
+      // Only when all groups have reached it is a full check done to confirm and release the barrier.
+      UInt32 m_group_size;
+      std::vector<bool> m_group_reached;
+
+      // Adaptive quantum: widened while cores do not interact, tightened on coherence traffic between cores,
+      // thread wakeups and frequency changes. Barriers are never placed past a timeout or periodic callback deadline.
+      bool m_adaptive;
+      SubsecondTime m_min_interval;
+      SubsecondTime m_max_interval;
+      UInt64 m_skew_budget; // Number of interactions per quantum that are allowed to observe up to a quantum of skew
+      UInt64 m_interactions;
+      UInt32 m_cpufreq_changed; // Set from the DVFS hook on any thread, accessed atomically
+      std::vector<SubsecondTime> m_periodic_intervals;
       SubsecondTime m_global_time;
       bool m_fastforward;
       volatile bool m_disable;
 
-      bool isBarrierReached(void);
+      bool isBarrierReached(core_id_t core_id = INVALID_CORE_ID);
+      bool isGroupReached(UInt32 group, bool &single_core_barrier_reached);
+      void resetGroups();
+      SubsecondTime computeNextBarrierTime();
       bool barrierRelease(thread_id_t thread_id = INVALID_THREAD_ID, bool continue_until_release = false);
       void abortBarrier(void);
       bool isCoreRunning(core_id_t core_id, bool siblings = true);
@@ -41,6 +61,14 @@ class BarrierSyncServer : public ClockSkewMinimizationServer
       static SInt64 hookThreadMigrate(UInt64 object, UInt64 argument) {
          ((BarrierSyncServer*)object)->threadMigrate((HooksManager::ThreadMigrate*)argument); return 0;
       }
+      static SInt64 hookThreadResume(UInt64 object, UInt64 argument) {
+         if (((HooksManager::ThreadResume*)argument)->thread_by != INVALID_THREAD_ID)
+            ((BarrierSyncServer*)object)->notifyInteraction();
+         return 0;
+      }
+      static SInt64 hookCpufreqChange(UInt64 object, UInt64 argument) {
+         __sync_fetch_and_or(&((BarrierSyncServer*)object)->m_cpufreq_changed, 1); return 0;
+      }
       void threadExit(HooksManager::ThreadTime *argument);
       void threadStall(HooksManager::ThreadStall *argument);
       void threadMigrate(HooksManager::ThreadMigrate *argument);
@@ -58,6 +86,8 @@ class BarrierSyncServer : public ClockSkewMinimizationServer
       SubsecondTime getGlobalTime(bool upper_bound = false) { return upper_bound ? m_next_barrier_time : m_global_time; }
       void setBarrierInterval(SubsecondTime barrier_interval) { m_barrier_interval = barrier_interval; }
       SubsecondTime getBarrierInterval() const { return m_barrier_interval; }
+      void notifyInteraction() { if (m_adaptive) __sync_fetch_and_add(&m_interactions, 1); }
+      void addPeriodicInterval(SubsecondTime interval);
 
       void printState(void);
 };
@@ -0,0 +1,227 @@
+#include "checkpoint_manager.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "hooks_manager.h"
+#include "magic_server.h"
+#include "log.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+   // Last HotSpot temperatures (Temperature.init in the output directory, written by tools/mcpat.py),
+   // restored so the first thermal epoch of a warm-started run does not begin from ambient
+   class ThermalCheckpoint : public Checkpointable
+   {
+      public:
+         ThermalCheckpoint()
+            : m_filename(Sim()->getConfig()->formatOutputFileName("Temperature.init"))
+         {}
+
+         void saveCheckpoint(std::ostream &os)
+         {
+            std::ifstream ifs(m_filename.c_str());
+            std::stringstream ss;
+            ss << ifs.rdbuf();
+            std::string data = ss.str();
+            CheckpointManager::write<UInt64>(os, data.size());
+            os.write(data.data(), data.size());
+         }
+
+         void loadCheckpoint(std::istream &is)
+         {
+            UInt64 size = CheckpointManager::read<UInt64>(is);
+            std::string data(size, '\0');
+            is.read(&data[0], size);
+            if (size)
+            {
+               std::ofstream ofs(m_filename.c_str());
+               ofs.write(data.data(), size);
+            }
+         }
+
+      private:
+         const String m_filename;
+   };
+}
+
+CheckpointManager::CheckpointManager()
+   : m_thermal(NULL)
+   , m_save_filename(Sim()->getCfg()->getString("checkpoint/save"))
+   , m_restore_filename(Sim()->getCfg()->getString("checkpoint/restore"))
+   , m_save_marker(Sim()->getCfg()->getInt("checkpoint/save_marker"))
+   , m_save_time(SubsecondTime::NS(Sim()->getCfg()->getInt("checkpoint/save_time")))
+   , m_save_pending(false)
+   , m_saved(false)
+{
+   String trigger = Sim()->getCfg()->getString("checkpoint/save_trigger");
+   if (trigger == "roi-begin")
+      m_save_trigger = TRIGGER_ROI_BEGIN;
+   else if (trigger == "marker")
+      m_save_trigger = TRIGGER_MARKER;
+   else if (trigger == "time")
+      m_save_trigger = TRIGGER_TIME;
+   else
+      LOG_PRINT_ERROR("Invalid checkpoint/save_trigger %s", trigger.c_str());
+
+   if (Sim()->getCfg()->getBool("periodic_thermal/enabled"))
+   {
+      m_thermal = new ThermalCheckpoint();
+      registerObject("thermal", 0, m_thermal);
+   }
+
+   if (m_restore_filename != "")
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_SIM_START, CheckpointManager::hook_sim_start, (UInt64)this);
+
+   if (m_save_filename != "")
+   {
+      // Saving is deferred to the next barrier, where all simulation threads are stopped
+      if (m_save_trigger == TRIGGER_ROI_BEGIN)
+         Sim()->getHooksManager()->registerHook(HookType::HOOK_ROI_BEGIN, CheckpointManager::hook_roi_begin, (UInt64)this);
+      else if (m_save_trigger == TRIGGER_MARKER)
+         Sim()->getHooksManager()->registerHook(HookType::HOOK_MAGIC_MARKER, CheckpointManager::hook_magic_marker, (UInt64)this);
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, CheckpointManager::hook_periodic, (UInt64)this);
+   }
+}
+
+CheckpointManager::~CheckpointManager()
+{
+   if (m_thermal)
+   {
+      unregisterObject("thermal", 0);
+      delete m_thermal;
+   }
+}
+
+String
+CheckpointManager::getKey(String name, UInt32 index)
+{
+   return name + "[" + itostr(index) + "]";
+}
+
+void
+CheckpointManager::registerObject(String name, UInt32 index, Checkpointable *object)
+{
+   ScopedLock sl(m_lock);
+
+   String key = getKey(name, index);
+   LOG_ASSERT_ERROR(m_objects.count(key) == 0, "Checkpoint object %s registered twice", key.c_str());
+   m_objects[key] = object;
+}
+
+void
+CheckpointManager::unregisterObject(String name, UInt32 index)
+{
+   ScopedLock sl(m_lock);
+
+   m_objects.erase(getKey(name, index));
+}
+
+void
+CheckpointManager::save(String filename)
+{
+   ScopedLock sl(m_lock);
+
+   std::ofstream ofs(filename.c_str(), std::ios::binary);
+   LOG_ASSERT_ERROR(ofs.good(), "Could not open checkpoint file %s for writing", filename.c_str());
+
+   write<UInt32>(ofs, MAGIC);
+   write<UInt32>(ofs, VERSION);
+   write<UInt32>(ofs, m_objects.size());
+
+   for(std::map<String, Checkpointable*>::iterator it = m_objects.begin(); it != m_objects.end(); ++it)
+   {
+      std::ostringstream oss;
+      it->second->saveCheckpoint(oss);
+      std::string data = oss.str();
+
+      write<UInt32>(ofs, it->first.size());
+      ofs.write(it->first.data(), it->first.size());
+      write<UInt64>(ofs, data.size());
+      ofs.write(data.data(), data.size());
+   }
+
+   LOG_ASSERT_ERROR(ofs.good(), "Error writing checkpoint file %s", filename.c_str());
+   printf("[CHECKPOINT] Saved %zu objects to %s\n", m_objects.size(), filename.c_str());
+}
+
+void
+CheckpointManager::restore(String filename)
+{
+   ScopedLock sl(m_lock);
+
+   std::ifstream ifs(filename.c_str(), std::ios::binary);
+   LOG_ASSERT_ERROR(ifs.good(), "Could not open checkpoint file %s", filename.c_str());
+
+   UInt32 magic = read<UInt32>(ifs);
+   UInt32 version = read<UInt32>(ifs);
+   LOG_ASSERT_ERROR(ifs.good() && magic == MAGIC, "%s is not a checkpoint file", filename.c_str());
+   LOG_ASSERT_ERROR(version == VERSION, "Checkpoint %s has version %u, expected %u", filename.c_str(), version, VERSION);
+
+   UInt32 num_sections = read<UInt32>(ifs);
+   UInt32 num_restored = 0;
+   for(UInt32 i = 0; i < num_sections; ++i)
+   {
+      UInt32 length = read<UInt32>(ifs);
+      std::string key(length, '\0');
+      ifs.read(&key[0], length);
+      UInt64 size = read<UInt64>(ifs);
+      std::string data(size, '\0');
+      ifs.read(&data[0], size);
+      LOG_ASSERT_ERROR(ifs.good(), "Checkpoint file %s is truncated", filename.c_str());
+
+      std::map<String, Checkpointable*>::iterator it = m_objects.find(String(key.c_str()));
+      if (it == m_objects.end())
+      {
+         LOG_PRINT_WARNING("Checkpoint section %s does not match any simulated object, ignoring", key.c_str());
+         continue;
+      }
+
+      std::istringstream iss(data);
+      it->second->loadCheckpoint(iss);
+      LOG_ASSERT_ERROR(iss.good() && UInt64(iss.tellg()) == size,
+                       "Checkpoint section %s does not match the current configuration", key.c_str());
+      ++num_restored;
+   }
+
+   if (num_restored != m_objects.size())
+      LOG_PRINT_WARNING("Checkpoint %s restored only %u out of %zu objects", filename.c_str(), num_restored, m_objects.size());
+   printf("[CHECKPOINT] Restored %u objects from %s\n", num_restored, filename.c_str());
+}
+
+void
+CheckpointManager::simStart()
+{
+   restore(m_restore_filename);
+}
+
+void
+CheckpointManager::roiBegin()
+{
+   m_save_pending = true;
+}
+
+void
+CheckpointManager::magicMarker(UInt64 arg)
+{
+   MagicServer::MagicMarkerType *marker = (MagicServer::MagicMarkerType *)arg;
+   if (marker->arg0 == m_save_marker)
+      m_save_pending = true;
+}
+
+void
+CheckpointManager::periodic(SubsecondTime time)
+{
+   if (m_saved)
+      return;
+
+   if (m_save_trigger == TRIGGER_TIME && time >= m_save_time)
+      m_save_pending = true;
+
+   if (m_save_pending)
+   {
+      save(Sim()->getConfig()->formatOutputFileName(m_save_filename));
+      m_saved = true;
+   }
+}
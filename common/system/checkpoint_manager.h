@@ -0,0 +1,78 @@
+#ifndef __CHECKPOINT_MANAGER_H
+#define __CHECKPOINT_MANAGER_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "lock.h"
+
+#include <map>
+#include <iostream>
+
+// Components whose microarchitectural state can be saved into a checkpoint,
+// and restored from it to warm-start a later simulation.
+// Not checkpointed, and therefore cold after a restore: branch predictors, the DRAM and
+// network queue models (keyed on absolute simulated time, which restarts at zero),
+// and the learned XCS classifiers of the xcs DVFS policy
+class Checkpointable
+{
+   public:
+      virtual ~Checkpointable() {}
+      virtual void saveCheckpoint(std::ostream &os) = 0;
+      virtual void loadCheckpoint(std::istream &is) = 0;
+};
+
+class CheckpointManager
+{
+   public:
+      CheckpointManager();
+      ~CheckpointManager();
+
+      void registerObject(String name, UInt32 index, Checkpointable *object);
+      void unregisterObject(String name, UInt32 index);
+
+      void save(String filename);
+      void restore(String filename);
+
+      template <typename T> static void write(std::ostream &os, const T &value)
+      { os.write((const char*)&value, sizeof(T)); }
+      template <typename T> static T read(std::istream &is)
+      { T value; is.read((char*)&value, sizeof(T)); return value; }
+
+   private:
+      // File layout: magic, version, number of sections, then per section
+      // its name (length + characters), payload size and payload
+      static const UInt32 MAGIC = 0x54504b43; // "CKPT"
+      static const UInt32 VERSION = 3;
+
+      enum trigger_t {
+         TRIGGER_ROI_BEGIN,
+         TRIGGER_MARKER,
+         TRIGGER_TIME,
+      };
+
+      Lock m_lock;
+      std::map<String, Checkpointable*> m_objects;
+      Checkpointable *m_thermal;
+
+      String m_save_filename;
+      String m_restore_filename;
+      trigger_t m_save_trigger;
+      UInt64 m_save_marker;
+      SubsecondTime m_save_time;
+      bool m_save_pending;
+      bool m_saved;
+
+      static String getKey(String name, UInt32 index);
+
+      static SInt64 hook_sim_start(UInt64 self, UInt64) { ((CheckpointManager*)self)->simStart(); return 0; }
+      static SInt64 hook_roi_begin(UInt64 self, UInt64) { ((CheckpointManager*)self)->roiBegin(); return 0; }
+      static SInt64 hook_magic_marker(UInt64 self, UInt64 arg) { ((CheckpointManager*)self)->magicMarker(arg); return 0; }
+      static SInt64 hook_periodic(UInt64 self, UInt64 time) { ((CheckpointManager*)self)->periodic(*(subsecond_time_t*)&time); return 0; }
+
+      void simStart();
+      void roiBegin();
+      void magicMarker(UInt64 arg);
+      void periodic(SubsecondTime time);
+};
+
+#endif // __CHECKPOINT_MANAGER_H
@@ -64,6 +64,9 @@ public:
    virtual SubsecondTime getGlobalTime(bool upper_bound = false);
    virtual void setBarrierInterval(SubsecondTime barrier_interval) = 0;
    virtual SubsecondTime getBarrierInterval() const = 0;
+   // Hints for servers that adapt their synchronization interval
+   virtual void notifyInteraction() {}
+   virtual void addPeriodicInterval(SubsecondTime interval) {}
 
    virtual void printState(void) {}
 };
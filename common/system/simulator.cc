@@ -18,6 +18,7 @@
 #include "dvfs_manager.h"
 #include "hooks_manager.h"
 #include "sampling_manager.h"
+#include "checkpoint_manager.h"
 #include "fault_injection.h"
 #include "routine_tracer.h"
 #include "instruction.h"
@@ -119,6 +120,7 @@ Simulator::Simulator()
    , m_dvfs_manager(NULL)
    , m_hooks_manager(NULL)
    , m_sampling_manager(NULL)
+   , m_checkpoint_manager(NULL)
    , m_faultinjection_manager(NULL)
    , m_rtn_tracer(NULL)
    , m_memory_tracker(NULL)
@@ -141,6 +143,7 @@ void Simulator::start()
    m_transport = Transport::create();
    m_dvfs_manager = new DvfsManager();
    m_faultinjection_manager = FaultinjectionManager::create();
+   m_checkpoint_manager = new CheckpointManager();
    m_thread_stats_manager = new ThreadStatsManager();
    m_clock_skew_minimization_manager = ClockSkewMinimizationManager::create();
    m_clock_skew_minimization_server = ClockSkewMinimizationServer::create();
@@ -251,6 +254,7 @@ Simulator::~Simulator()
    //delete m_thread_manager;            m_thread_manager = NULL;
    delete m_thread_stats_manager;      m_thread_stats_manager = NULL;
    delete m_core_manager;              m_core_manager = NULL;
+   delete m_checkpoint_manager;        m_checkpoint_manager = NULL;
    delete m_dvfs_manager;              m_dvfs_manager = NULL;
    delete m_magic_server;              m_magic_server = NULL;
    delete m_sync_server;               m_sync_server = NULL;
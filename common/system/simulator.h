@@ -27,6 +27,7 @@ class DvfsManager;
 class SamplingManager;
 class FaultinjectionManager;
 class TagsManager;
+class CheckpointManager;
 class RoutineTracer;
 class MemoryTracker;
 namespace config { class Config; }
@@ -65,6 +66,7 @@ public:
    DvfsManager *getDvfsManager() { return m_dvfs_manager; }
    HooksManager *getHooksManager() { return m_hooks_manager; }
    SamplingManager *getSamplingManager() { return m_sampling_manager; }
+   CheckpointManager *getCheckpointManager() { return m_checkpoint_manager; }
    FaultinjectionManager *getFaultinjectionManager() { return m_faultinjection_manager; }
    TraceManager *getTraceManager() { return m_trace_manager; }
    TagsManager *getTagsManager() { return m_tags_manager; }
@@ -103,6 +105,7 @@ private:
    DvfsManager *m_dvfs_manager;
    HooksManager *m_hooks_manager;
    SamplingManager *m_sampling_manager;
+   CheckpointManager *m_checkpoint_manager;
    FaultinjectionManager *m_faultinjection_manager;
    RoutineTracer *m_rtn_tracer;
    MemoryTracker *m_memory_tracker;
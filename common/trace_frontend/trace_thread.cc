@@ -51,6 +51,7 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
    , m_tracefile(tracefile)
    , m_responsefile(responsefile)
    , m_app_id(app_id)
+   , m_start_instruction(Sim()->getCfg()->getIntArray("traceinput/start_instruction", app_id))
    , m_blocked(false)
    , m_cleanup(cleanup)
    , m_started(false)
@@ -66,6 +67,11 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
    //   xed_initialized = true;
    //}
 
+   // Offline traces can be read and decompressed by a helper thread
+   UInt64 read_ahead = Sim()->getCfg()->getInt("traceinput/read_ahead");
+   if (read_ahead && responsefile == "")
+      m_trace.setReadAhead(read_ahead * 1024);
+
    m_trace.setHandleInstructionCountFunc(TraceThread::__handleInstructionCountFunc, this);
    m_trace.setHandleCacheOnlyFunc(TraceThread::__handleCacheOnlyFunc, this);
    if (Sim()->getCfg()->getBool("traceinput/mirror_output"))
@@ -95,11 +101,15 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
    }
 
    thread->setVa2paFunc(_va2pa, (UInt64)this);
-   
+
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->registerObject("trace-thread", thread->getId(), this);
 }
 
 TraceThread::~TraceThread()
 {
+   if (Sim()->getCheckpointManager())
+      Sim()->getCheckpointManager()->unregisterObject("trace-thread", m_thread->getId());
    delete m__thread;
    if (m_cleanup)
    {
@@ -778,6 +788,15 @@ void TraceThread::run()
    m_trace.initStream();
    m_trace_has_pa = m_trace.getTraceHasPhysicalAddresses();
 
+   // Optionally start replay part-way into the trace using its index (recorded with sift_recorder -index),
+   // either from traceinput/start_instruction or from the position stored in a restored checkpoint
+   if (m_start_instruction)
+   {
+      LOG_ASSERT_ERROR(m_responsefile == "", "Starting part-way into a trace is not supported when using response files");
+      bool found = m_trace.Seek(m_start_instruction);
+      LOG_ASSERT_ERROR(found, "Could not start trace %s at instruction %ld, is there a trace index?", m_tracefile.c_str(), m_start_instruction);
+   }
+
    if (m_thread->getCore() == NULL)
    {
       // We didn't get scheduled on startup, wait here
@@ -890,6 +909,17 @@ UInt64 TraceThread::getProgressValue()
    return m_trace.getPosition();
 }
 
+void TraceThread::saveCheckpoint(std::ostream &os)
+{
+   CheckpointManager::write<UInt64>(os, m_trace.getInstructionCount());
+}
+
+void TraceThread::loadCheckpoint(std::istream &is)
+{
+   LOG_ASSERT_ERROR(!m_started, "Cannot restore the trace position of a thread that has already started");
+   m_start_instruction = CheckpointManager::read<UInt64>(is);
+}
+
 void TraceThread::handleAccessMemory(Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size)
 {
    Sift::MemoryLockType sift_lock_signal;
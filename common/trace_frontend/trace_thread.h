@@ -8,6 +8,7 @@
 #include "sift_reader.h"
 #include "operand.h"
 #include "semaphore.h"
+#include "checkpoint_manager.h"
 
 #include <decoder.h>
 
@@ -29,7 +30,7 @@
 class Instruction;
 class DynamicInstruction;
 
-class TraceThread : public Runnable
+class TraceThread : public Runnable, public Checkpointable
 {
    private:
       // In multi-process mode, we want each process to have its own private memory space
@@ -75,6 +76,7 @@ class TraceThread : public Runnable
       String m_tracefile;
       String m_responsefile;
       app_id_t m_app_id;
+      UInt64 m_start_instruction;
       bool m_blocked;
       bool m_cleanup;
       bool m_started;
@@ -145,6 +147,10 @@ class TraceThread : public Runnable
       UInt64 getProgressValue();
       Thread* getThread() const { return m_thread; }
       void handleAccessMemory(Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size);
+
+      // Checkpointable: position in the trace, restored by seeking there once the thread starts
+      void saveCheckpoint(std::ostream &os);
+      void loadCheckpoint(std::istream &is);
 };
 
 #endif // __TRACE_THREAD_H
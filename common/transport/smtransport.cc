@@ -68,6 +68,7 @@ void SmTransport::clearNodeForId(core_id_t core_id)
 
 SmTransport::SmNode::SmNode(core_id_t core_id, SmTransport *smt)
    : Node(core_id)
+   , m_waiting(false)
    , m_smt(smt)
 {
 }
@@ -91,6 +92,16 @@ void SmTransport::SmNode::send(SInt32 dest_id, const void* buffer, UInt32 length
    send(dest_node, buffer, length);
 }
 
+void SmTransport::SmNode::sendBuffer(SInt32 dest_id, Byte* buffer, UInt32 length)
+{
+   SmNode *dest_node = m_smt->getNodeFromId(dest_id);
+   LOG_ASSERT_ERROR(dest_node != NULL, "Attempt to send to non-existent node: %d", dest_id);
+
+   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, buffer, dest_node);
+
+   dest_node->enqueue(buffer);
+}
+
 void SmTransport::SmNode::send(SmNode *dest_node, const void *buffer, UInt32 length)
 {
    Byte *data = new Byte[length];
@@ -98,44 +109,43 @@ void SmTransport::SmNode::send(SmNode *dest_node, const void *buffer, UInt32 len
 
    LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, data, dest_node);
 
-   dest_node->m_lock.acquire();
-   dest_node->m_queue.push(data);
-   dest_node->m_lock.release();
-   dest_node->m_cond.broadcast();
+   dest_node->enqueue(data);
+}
+
+void SmTransport::SmNode::enqueue(Byte *buffer)
+{
+   m_queue.push(buffer);
+
+   // Only wake up the receiver when it has announced it is going to sleep (see recv()).
+   // Taking m_lock makes sure it is already waiting on m_cond by the time we broadcast.
+   if (__atomic_load_n(&m_waiting, __ATOMIC_SEQ_CST))
+   {
+      ScopedLock sl(m_lock);
+      m_cond.broadcast();
+   }
 }
 
 Byte* SmTransport::SmNode::recv()
 {
    LOG_PRINT("attempting recv -- this: %p", this);
 
-   m_lock.acquire();
-
-   while (true)
+   Byte *data;
+   while (!m_queue.pop(data))
    {
-      if (!m_queue.empty())
-      {
-         Byte *data = m_queue.front();
-         m_queue.pop();
-         m_lock.release();
-
-         LOG_PRINT("msg recv'd -- data: %p, this: %p", data, this);
-
-         return data;
-      }
-      else
-      {
+      ScopedLock sl(m_lock);
+      __atomic_store_n(&m_waiting, true, __ATOMIC_SEQ_CST);
+      // Re-check: a sender may have pushed before it could see m_waiting
+      if (m_queue.empty())
          m_cond.wait(m_lock);
-      }
+      __atomic_store_n(&m_waiting, false, __ATOMIC_SEQ_CST);
    }
+
+   LOG_PRINT("msg recv'd -- data: %p, this: %p", data, this);
+
+   return data;
 }
 
 bool SmTransport::SmNode::query()
 {
-   bool result = false;
-
-   m_lock.acquire();
-   result = !m_queue.empty();
-   m_lock.release();
-
-   return result;
+   return !m_queue.empty();
 }
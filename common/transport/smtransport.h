@@ -1,10 +1,9 @@
 #ifndef SMTRANSPORT_H
 #define SMTRANSPORT_H
 
-#include <queue>
-
 #include "transport.h"
 #include "cond.h"
+#include "lockfree_queue.h"
 
 class SmTransport : public Transport
 {
@@ -20,13 +19,17 @@ public:
 
       void globalSend(SInt32, const void*, UInt32);
       void send(core_id_t, const void*, UInt32);
+      void sendBuffer(core_id_t, Byte*, UInt32);
       Byte* recv();
       bool query();
 
    private:
       void send(SmNode *dest, const void *buffer, UInt32 length);
+      void enqueue(Byte *buffer);
 
-      std::queue<Byte*> m_queue;
+      // Senders push without taking a lock, m_lock and m_cond are only used when the receiver has to sleep
+      LockFreeQueue<Byte*> m_queue;
+      volatile bool m_waiting;
       Lock m_lock;
       ConditionVariable m_cond;
       SmTransport *m_smt;
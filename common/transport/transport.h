@@ -17,6 +17,8 @@ public:
 
       virtual void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length) = 0;
       virtual void send(core_id_t dest, const void *buffer, UInt32 length) = 0;
+      // Like send(), but hands buffer (allocated with new Byte[]) over to the receiver instead of copying it
+      virtual void sendBuffer(core_id_t dest, Byte *buffer, UInt32 length) = 0;
       virtual Byte* recv() = 0;
       virtual bool query() = 0;
 
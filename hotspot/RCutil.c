@@ -6,11 +6,15 @@
  * from the BLAS and LAPACK packages in  lieu of
  * the vanilla C code present in the matrix functions 
  * of the previous versions of HotSpot. 
+ * without it, the dense kernels below work on tiles
+ * of the contiguous, row-major matrices from dmatrix,
+ * with OpenMP threads and SIMD directives.
  */
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <math.h>
+#include <float.h>
 
 #include "temperature.h"
 #include "flp.h"
@@ -29,6 +33,107 @@ double getcap(double sp_heat, double thickness, double area)
 	return C_FACTOR * sp_heat * thickness * area;
 }
 
+/* 
+ * c += alpha * a * b for an m by k matrix 'a' and a k by n matrix 'b'.
+ * all three are row-major with leading dimensions lda, ldb and ldc.
+ * the MAT_BLOCK square tiles of c are independent and run in parallel.
+ * per tile, the rows of b used stay in cache and MAT_STRIP wide strips
+ * of a row of c are accumulated in (SIMD) registers
+ */
+static void gemm_block(int m, int n, int k, double alpha, double *a, int lda,
+					   double *b, int ldb, double *c, int ldc)
+{
+	int t, ti, tj, ie, je, le, i, j, l, l0, v;
+	int ntj = (n + MAT_BLOCK - 1) / MAT_BLOCK;
+	int ntiles = (m + MAT_BLOCK - 1) / MAT_BLOCK * ntj;
+	double *ai, *ci, *bl, ail, acc[MAT_STRIP];
+
+#pragma omp parallel for private(ti, tj, ie, je, le, i, j, l, l0, v, ai, ci, bl, ail, acc) if ((double) m * n * k >= (double) MAT_PARALLEL_MIN * MAT_PARALLEL_MIN * MAT_PARALLEL_MIN)
+	for (t = 0; t < ntiles; t++) {
+		ti = (t / ntj) * MAT_BLOCK;
+		tj = (t % ntj) * MAT_BLOCK;
+		ie = MIN(ti + MAT_BLOCK, m);
+		je = MIN(tj + MAT_BLOCK, n);
+		for (l0 = 0; l0 < k; l0 += MAT_BLOCK) {
+			le = MIN(l0 + MAT_BLOCK, k);
+			for (i = ti; i < ie; i++) {
+				ai = a + (size_t) i * lda;
+				ci = c + (size_t) i * ldc;
+				for (j = tj; j + MAT_STRIP <= je; j += MAT_STRIP) {
+					for (v = 0; v < MAT_STRIP; v++)
+						acc[v] = 0;
+					for (l = l0; l < le; l++) {
+						bl = b + (size_t) l * ldb + j;
+#pragma omp simd
+						for (v = 0; v < MAT_STRIP; v++)
+							acc[v] += ai[l] * bl[v];
+					}
+					for (v = 0; v < MAT_STRIP; v++)
+						ci[j+v] += alpha * acc[v];
+				}
+				/* remainder of the row	*/
+				for (l = l0; l < le; l++) {
+					ail = alpha * ai[l];
+					bl = b + (size_t) l * ldb;
+					for (v = j; v < je; v++)
+						ci[v] += ail * bl[v];
+				}
+			}
+		}
+	}
+}
+
+/* 
+ * solves l * x = x in place for the k columns of the n by k row-major
+ * matrix 'x', where 'l' is the unit lower triangle of the in-place lu
+ * decomposition 'a' (or u * x = x for the upper triangle, if 'upper' 
+ * is set). all columns are solved at once, MAT_BLOCK rows at a time:
+ * the contribution of the rows solved before is a matrix product
+ */
+static void trsm_block(double **a, int n, double *x, int k, int upper)
+{
+	int ib, ie, i, j, v;
+	double *xi, *xj, aij;
+
+	if (!upper) {
+		for (ib = 0; ib < n; ib += MAT_BLOCK) {
+			ie = MIN(ib + MAT_BLOCK, n);
+			if (ib > 0)
+				gemm_block(ie - ib, k, ib, -1.0, a[ib], n, x, k, x + (size_t) ib * k, k);
+			for (i = ib; i < ie; i++) {
+				xi = x + (size_t) i * k;
+				for (j = ib; j < i; j++) {
+					aij = a[i][j];
+					xj = x + (size_t) j * k;
+#pragma omp simd
+					for (v = 0; v < k; v++)
+						xi[v] -= aij * xj[v];
+				}
+			}
+		}
+	} else {
+		for (ie = n; ie > 0; ie = ib) {
+			ib = MAX(ie - MAT_BLOCK, 0);
+			if (ie < n)
+				gemm_block(ie - ib, k, n - ie, -1.0, a[ib] + ie, n, x + (size_t) ie * k, k, x + (size_t) ib * k, k);
+			for (i = ie - 1; i >= ib; i--) {
+				xi = x + (size_t) i * k;
+				for (j = i + 1; j < ie; j++) {
+					aij = a[i][j];
+					xj = x + (size_t) j * k;
+#pragma omp simd
+					for (v = 0; v < k; v++)
+						xi[v] -= aij * xj[v];
+				}
+				aij = 1.0 / a[i][i];
+#pragma omp simd
+				for (v = 0; v < k; v++)
+					xi[v] *= aij;
+			}
+		}
+	}
+}
+
 /*
  * LUP decomposition from the pseudocode given in the CLR 
  * 'Introduction to Algorithms' textbook. The matrix 'a' is
@@ -72,46 +177,70 @@ void lupdcmp(double**a, int n, int *p, int spd)
 		dpotrf_("U", &n, a[0], &n, &info);
 	assert(info == 0);	
 	#else
-	int i, j, k, pivot=0;
-	double max = 0;
+	int i, j, k, kb, ke, pivot=0;
+	double max = 0, lik, *ri, *rk;
 
 	/* start with identity permutation	*/
 	for (i=0; i < n; i++)
 		p[i] = i;
 
-	for (k=0; k < n-1; k++)	 {
-		max = 0;
-		for (i = k; i < n; i++)	{
-			if (fabs(a[i][k]) > max) {
-				max = fabs(a[i][k]);
-				pivot = i;
+	/* 
+	 * blocked right-looking form of the above: each panel of MAT_BLOCK
+	 * columns is factored as before, the rest of the trailing matrix is
+	 * then updated at once by a matrix product
+	 */
+	for (kb=0; kb < n; kb += MAT_BLOCK) {
+		ke = MIN(kb + MAT_BLOCK, n);
+
+		for (k=kb; k < ke && k < n-1; k++) {
+			max = 0;
+			for (i = k; i < n; i++)	{
+				if (fabs(a[i][k]) > max) {
+					max = fabs(a[i][k]);
+					pivot = i;
+				}
+			}	
+			if (eq (max, 0))
+				fatal ("singular matrix in lupdcmp\n");
+
+			/* bring pivot element to position	*/
+			swap_ival (&p[k], &p[pivot]);
+			if (pivot != k)
+				for (i=0; i < n; i++)
+					swap_dval (&a[k][i], &a[pivot][i]);
+
+			/* update within the panel	*/
+			rk = a[k];
+#pragma omp parallel for private(j, ri, lik) if (n-k >= MAT_PARALLEL_MIN)
+			for (i=k+1; i < n; i++) {
+				ri = a[i];
+				lik = ri[k] /= rk[k];
+#pragma omp simd
+				for (j=k+1; j < ke; j++)
+					ri[j] -= lik * rk[j];
 			}
-		}	
-		if (eq (max, 0))
-			fatal ("singular matrix in lupdcmp\n");
-
-		/* bring pivot element to position	*/
-		swap_ival (&p[k], &p[pivot]);
-		for (i=0; i < n; i++)
-			swap_dval (&a[k][i], &a[pivot][i]);
-
-		for (i=k+1; i < n; i++) {
-			a[i][k] /= a[k][k];
-			for (j=k+1; j < n; j++)
-				a[i][j] -= a[i][k] * a[k][j];
 		}
+		if (ke == n)
+			break;
+
+		/* rows of u right of the panel: forward substitution	*/
+		for (k=kb; k < ke; k++) {
+			rk = a[k];
+			for (i=k+1; i < ke; i++) {
+				ri = a[i];
+				lik = ri[k];
+#pragma omp simd
+				for (j=ke; j < n; j++)
+					ri[j] -= lik * rk[j];
+			}
+		}
+
+		/* trailing matrix	*/
+		gemm_block(n-ke, n-ke, ke-kb, -1.0, &a[ke][kb], n, &a[kb][ke], n, &a[ke][ke], n);
 	}
 	#endif
 }
 
-/* 
- * the matrix a is an in-place lower/upper triangular matrix
- * the following macros split them into their constituents
- */
-
-#define LOWER(a, i, j)		((i > j) ? a[i][j] : 0)
-#define UPPER(a, i, j)		((i <= j) ? a[i][j] : 0)
-
 /* 
  * LU forward and backward substitution from the pseudocode given
  * in the CLR 'Introduction to Algorithms' textbook. It solves ax = b
@@ -161,26 +290,133 @@ void lusolve(double **a, int n, int *p, double *b, double *x, int spd)
 	#else
 	int i, j;
 	double *y = dvector (n);
-	double sum;
+	double sum, *ai;
 
+	/* 
+	 * the loops run over the lower/upper part only, 
+	 * so that the dot products are vectorized
+	 */
 	/* forward substitution	- solves ly = pb	*/
 	for (i=0; i < n; i++) {
-		for (j=0, sum=0; j < i; j++)
-			sum += y[j] * LOWER(a, i, j);
+		ai = a[i];
+		sum = 0;
+#pragma omp simd reduction(+:sum)
+		for (j=0; j < i; j++)
+			sum += y[j] * ai[j];
 		y[i] = b[p[i]] - sum;
 	}
 
 	/* backward substitution - solves ux = y	*/
 	for (i=n-1; i >= 0; i--) {
-		for (j=i+1, sum=0; j < n; j++)
-			sum += x[j] * UPPER(a, i, j);
-		x[i] = (y[i] - sum) / UPPER(a, i, i);
+		ai = a[i];
+		sum = 0;
+#pragma omp simd reduction(+:sum)
+		for (j=i+1; j < n; j++)
+			sum += x[j] * ai[j];
+		x[i] = (y[i] - sum) / ai[i];
 	}
 
 	free_dvector(y);
 	#endif
 }
 
+/* 
+ * same as above for 'k' right hand sides at once. b[i] and x[i]
+ * are the i-th right hand side and solution vectors. with math 
+ * acceleration, all of them are solved in a single (level 3)
+ * LAPACK call, without it by the blocked triangular solves above
+ */
+void lusolve_multi(double **a, int n, int *p, double **b, double **x, int k, int spd)
+{
+	int i;
+	#if (MATHACCEL != MA_NONE)
+	int info = 0;
+	/* LAPACK wants the right hand sides as contiguous columns	*/
+	double **xt = dmatrix(k, n);
+	for (i = 0; i < k; i++)
+		copy_dvector(xt[i], b[i], n);
+	#endif
+
+	#if(MATHACCEL == MA_INTEL)
+	if (!spd)
+		dgetrs("T", &n, &k, a[0], &n, p, xt[0], &n, &info);
+	else	
+		dpotrs("U", &n, &k, a[0], &n, xt[0], &n, &info);
+	#elif(MATHACCEL == MA_AMD)
+	if (!spd)
+		dgetrs_("T", &n, &k, a[0], &n, p, xt[0], &n, &info, 1);
+	else	
+		dpotrs_("U", &n, &k, a[0], &n, xt[0], &n, &info, 1);
+	#elif(MATHACCEL == MA_APPLE)
+	if (!spd)
+		dgetrs_("T", (__CLPK_integer *)&n, (__CLPK_integer *)&k, a[0],
+				(__CLPK_integer *)&n, (__CLPK_integer *)p, xt[0],
+				(__CLPK_integer *)&n, (__CLPK_integer *)&info);
+	else	
+		dpotrs_("U", (__CLPK_integer *)&n, (__CLPK_integer *)&k, a[0],
+				(__CLPK_integer *)&n, xt[0], (__CLPK_integer *)&n,
+				(__CLPK_integer *)&info);
+	#elif(MATHACCEL == MA_SUN)
+	if (!spd)
+		dgetrs_("T", &n, &k, a[0], &n, p, xt[0], &n, &info);
+	else	
+		dpotrs_("U", &n, &k, a[0], &n, xt[0], &n, &info);
+	#else
+	/* right hand sides as columns, as LAPACK does	*/
+	int j;
+	double **xt = dmatrix(n, k);
+	for (i = 0; i < n; i++)
+		for (j = 0; j < k; j++)
+			xt[i][j] = b[j][p[i]];
+	trsm_block(a, n, xt[0], k, FALSE);
+	trsm_block(a, n, xt[0], k, TRUE);
+	for (j = 0; j < k; j++)
+		for (i = 0; i < n; i++)
+			x[j][i] = xt[i][j];
+	free_dmatrix(xt);
+	#endif
+
+	#if (MATHACCEL != MA_NONE)
+	assert(info == 0);
+	for (i = 0; i < k; i++)
+		copy_dvector(x[i], xt[i], n);
+	free_dmatrix(xt);
+	#endif
+}
+
+/* 
+ * inv = m^-1 from the lu decomposition 'a' and permutation 'p' of 
+ * m, as computed by lupdcmp. without math acceleration, the right
+ * hand sides are the columns of inv itself: it starts out as the
+ * permuted identity and is solved in place
+ */
+void luinv(double **a, int n, int *p, double **inv, int spd)
+{
+	int i, j;
+	#if (MATHACCEL != MA_NONE)
+	double **e = dmatrix(n, n), t;
+
+	/* inv[j] = m^-1 * e_j is the j-th column of the inverse	*/
+	zero_dmatrix(e, n, n);
+	for (j = 0; j < n; j++)
+		e[j][j] = 1.0;
+	lusolve_multi(a, n, p, e, inv, n, spd);
+	free_dmatrix(e);
+	for (i = 0; i < n; i++)
+		for (j = i + 1; j < n; j++) {
+			t = inv[i][j];
+			inv[i][j] = inv[j][i];
+			inv[j][i] = t;
+		}
+	#else
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			inv[i][j] = (j == p[i]);
+	trsm_block(a, n, inv[0], n, FALSE);
+	trsm_block(a, n, inv[0], n, TRUE);
+	#endif
+}
+
 /* core of the 4th order Runge-Kutta method, where the Euler step
  * (y(n+1) = y(n) + h * k1 where k1 = dydx(n)) is provided as an input.
  * to evaluate dydx at different points, a call back function f (slope
@@ -401,14 +637,8 @@ void matmult(double **c, double **a, double **b, int n)
 	/* B^T * A^T = (A * B)^T	*/
 	dgemm('N', 'N', n, n, n, 1.0, b[0], n, a[0], n, 0.0, c[0], n);
 	#else
-	int i, j, k;
-
-	for (i = 0; i < n; i++)
-		for (j = 0; j < n; j++) {
-			c[i][j] = 0;
-			for (k = 0; k < n; k++)
-				c[i][j] += a[i][k] * b[k][j];
-		}
+	zero_dmatrix(c, n, n);
+	gemm_block(n, n, n, 1.0, a[0], n, b[0], n, c[0], n);
 	#endif	
 }
 
@@ -427,7 +657,9 @@ void diagmatmult(double **c, double *a, double **b, int n)
 	#else
 	int j;
 
+#pragma omp parallel for private(j) if (n >= MAT_PARALLEL_MIN)
 	for (i = 0; i < n; i++)
+#pragma omp simd
 		for (j = 0; j < n; j++)
 			c[i][j] = a[i] * b[i][j];
 	#endif		
@@ -443,11 +675,15 @@ void matvectmult(double *vout, double **m, double *vin, int n)
 	dgemv('T', n, n, 1.0, m[0], n, vin, 1, 0.0, vout, 1);
 	#else
 	int i, j;
+	double sum;
 
+#pragma omp parallel for private(j, sum) if (n >= MAT_PARALLEL_MIN)
 	for (i = 0; i < n; i++) {
-		vout[i] = 0;
+		sum = 0;
+#pragma omp simd reduction(+:sum)
 		for (j = 0; j < n; j++)
-			vout[i] += m[i][j] * vin[j];
+			sum += m[i][j] * vin[j];
+		vout[i] = sum;
 	}
 	#endif
 }
@@ -478,11 +714,9 @@ void matinv(double **inv, double **m, int n, int spd)
 {
 	int *p, lwork;
 	double *work;
-	int i, j;
 	#if (MATHACCEL != MA_NONE)
 	int info;
 	#endif
-	double *col;
 
 	p = ivector(n);
 	lwork = n * BLOCK_SIZE;
@@ -555,24 +789,251 @@ void matinv(double **inv, double **m, int n, int spd)
 		mirror_dmatrix(inv, n);
 	}
 	#else
-	col = dvector(n);
-
 	lupdcmp(m, n, p, spd);
-
-	for (j = 0; j < n; j++) {
-		for (i = 0; i < n; i++) col[i]=0.0;
-		col[j] = 1.0;
-		lusolve(m, n, p, col, work, spd);
-		for (i = 0; i < n; i++) inv[i][j]=work[i];
-	}
-
-	free_dvector(col);
+	luinv(m, n, p, inv, spd);
 	#endif
 
 	free_ivector(p);
 	free_dvector(work);
 }
 
+/* 
+ * e = exp(m), e, m are n by n matrices. m is scaled down
+ * by a power of two until its norm is small enough for a
+ * truncated taylor series, whose sum is then squared back
+ */
+void matexp(double **e, double **m, int n)
+{
+	double **x, **term, **t;
+	double norm, row, scale = 1.0;
+	int i, j, k, squarings = 0;
+
+	/* infinity norm of m	*/
+	for (norm = 0, i = 0; i < n; i++) {
+		for (row = 0, j = 0; j < n; j++)
+			row += fabs(m[i][j]);
+		norm = MAX(norm, row);
+	}
+	while (norm * scale > EXP_MAX_NORM) {
+		scale *= 0.5;
+		squarings++;
+	}
+
+	x = dmatrix(n, n);
+	term = dmatrix(n, n);
+	t = dmatrix(n, n);
+
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			x[i][j] = scale * m[i][j];
+
+	/* e = term = I	*/
+	zero_dmatrix(e, n, n);
+	zero_dmatrix(term, n, n);
+	for (i = 0; i < n; i++)
+		e[i][i] = term[i][i] = 1.0;
+
+	/* e = sum of x^k / k!	*/
+	for (k = 1; k <= EXP_TERMS; k++) {
+		matmult(t, term, x, n);
+		for (i = 0; i < n; i++)
+			for (j = 0; j < n; j++) {
+				term[i][j] = t[i][j] / k;
+				e[i][j] += term[i][j];
+			}
+	}
+
+	/* exp(m) = exp(m * scale) ^ (1 / scale)	*/
+	for (k = 0; k < squarings; k++) {
+		matmult(t, e, e, n);
+		copy_dmatrix(e, t, n, n);
+	}
+
+	free_dmatrix(x);
+	free_dmatrix(term);
+	free_dmatrix(t);
+}
+
+/* 
+ * eigen decomposition of the symmetric n by n matrix a = v^T * diag(w) * v.
+ * the eigenvectors are returned in the rows of v, sorted by decreasing
+ * eigenvalue. a is destroyed. a is reduced to tridiagonal form by householder
+ * reflections, which are then accumulated and diagonalized by implicit QL
+ * iterations (as in EISPACK's tred2 and tql2). all O(n^3) loops run in
+ * parallel for n >= EIG_PARALLEL_MIN
+ */
+void symeig(double **a, int n, double *w, double **v)
+{
+	double **z, *d, *e, *p, *beta, *cs, *sn, *r;
+	double alpha, g, f, h, c, c2, c3, s, s2, el1, dl1, tst1, t;
+	int i, j, k, l, m, iter, kb;
+
+	z = dmatrix(n, n);
+	d = dvector(n);
+	e = dvector(n);
+	p = dvector(n);
+	beta = dvector(n);
+	cs = dvector(n);
+	sn = dvector(n);
+
+	/* 
+	 * householder reduction: column k is reflected onto its subdiagonal by
+	 * I - beta[k]*u*u^T, u is stored in place of the column below the diagonal
+	 */
+	for (k = 0; k < n - 2; k++) {
+		m = k + 1;
+		for (alpha = 0, i = m; i < n; i++)
+			alpha += a[i][k] * a[i][k];
+		beta[k] = 0;
+		e[k] = a[m][k];
+		if (alpha == 0.0)
+			continue;
+		alpha = (a[m][k] > 0) ? -sqrt(alpha) : sqrt(alpha);
+		a[m][k] -= alpha;
+		for (h = 0, i = m; i < n; i++)
+			h += a[i][k] * a[i][k];
+		beta[k] = 2.0 / h;
+		e[k] = alpha;
+
+		/* p = beta * a * u	*/
+#pragma omp parallel for private(j, t) if (n >= EIG_PARALLEL_MIN)
+		for (i = m; i < n; i++) {
+			for (t = 0, j = m; j < n; j++)
+				t += a[i][j] * a[j][k];
+			p[i] = beta[k] * t;
+		}
+		/* p -= (beta/2 * p^T * u) * u	*/
+		for (g = 0, i = m; i < n; i++)
+			g += p[i] * a[i][k];
+		g *= beta[k] / 2.0;
+		for (i = m; i < n; i++)
+			p[i] -= g * a[i][k];
+		/* a -= u * p^T + p * u^T	*/
+#pragma omp parallel for private(j) if (n >= EIG_PARALLEL_MIN)
+		for (i = m; i < n; i++)
+			for (j = m; j < n; j++)
+				a[i][j] -= a[i][k] * p[j] + p[i] * a[j][k];
+	}
+	for (i = 0; i < n; i++)
+		d[i] = a[i][i];
+	if (n > 1)
+		e[n-2] = a[n-1][n-2];
+	e[n-1] = 0;
+
+	/* accumulate the reflections backwards: z = q	*/
+	zero_dmatrix(z, n, n);
+	for (i = 0; i < n; i++)
+		z[i][i] = 1.0;
+	for (k = n - 3; k >= 0; k--) {
+		m = k + 1;
+		if (beta[k] == 0.0)
+			continue;
+		/* p^T = u^T * z	*/
+		zero_dvector(p, n);
+		for (i = m; i < n; i++)
+			for (j = m; j < n; j++)
+				p[j] += a[i][k] * z[i][j];
+#pragma omp parallel for private(j) if (n >= EIG_PARALLEL_MIN)
+		for (i = m; i < n; i++)
+			for (j = m; j < n; j++)
+				z[i][j] -= beta[k] * a[i][k] * p[j];
+	}
+	/* from here on, the rows of z are the eigenvectors	*/
+	for (i = 0; i < n; i++)
+		for (j = 0; j < i; j++) {
+			t = z[i][j];
+			z[i][j] = z[j][i];
+			z[j][i] = t;
+		}
+
+	/* implicit QL iterations on the tridiagonal matrix	*/
+	for (f = 0, tst1 = 0, l = 0; l < n; l++) {
+		tst1 = MAX(tst1, fabs(d[l]) + fabs(e[l]));
+		for (m = l; m < n - 1; m++)
+			if (fabs(e[m]) <= DBL_EPSILON * tst1)
+				break;
+		for (iter = 0; m > l; iter++) {
+			if (iter == EIG_MAX_ITER)
+				fatal("no convergence in symmetric eigen decomposition\n");
+
+			/* implicit shift	*/
+			g = d[l];
+			t = (d[l+1] - g) / (2.0 * e[l]);
+			h = hypot(t, 1.0);
+			if (t < 0)
+				h = -h;
+			d[l] = e[l] / (t + h);
+			d[l+1] = e[l] * (t + h);
+			dl1 = d[l+1];
+			h = g - d[l];
+			for (i = l + 2; i < n; i++)
+				d[i] -= h;
+			f += h;
+
+			/* QL sweep of givens rotations	*/
+			t = d[m];
+			c = c2 = c3 = 1.0;
+			el1 = e[l+1];
+			s = s2 = 0;
+			for (i = m - 1; i >= l; i--) {
+				c3 = c2;
+				c2 = c;
+				s2 = s;
+				g = c * e[i];
+				h = c * t;
+				alpha = hypot(t, e[i]);
+				e[i+1] = s * alpha;
+				s = e[i] / alpha;
+				c = t / alpha;
+				t = c * d[i] - s * g;
+				d[i+1] = h + s * (c * g + s * d[i]);
+				cs[i] = c;
+				sn[i] = s;
+			}
+			t = -s * s2 * c3 * el1 * e[l] / dl1;
+			e[l] = s * t;
+			d[l] = c * t;
+
+			/* rotate the eigenvectors, in independent blocks of columns	*/
+#pragma omp parallel for private(i, j, r, h) if (n >= EIG_PARALLEL_MIN)
+			for (kb = 0; kb < n; kb += EIG_BLOCK)
+				for (i = m - 1; i >= l; i--) {
+					r = z[i];
+					for (j = kb; j < MIN(kb + EIG_BLOCK, n); j++) {
+						h = z[i+1][j];
+						z[i+1][j] = sn[i] * r[j] + cs[i] * h;
+						r[j] = cs[i] * r[j] - sn[i] * h;
+					}
+				}
+
+			if (fabs(e[l]) <= DBL_EPSILON * tst1)
+				break;
+		}
+		d[l] += f;
+		e[l] = 0;
+	}
+
+	/* selection sort, descending	*/
+	for (i = 0; i < n; i++) {
+		for (k = i, j = i+1; j < n; j++)
+			if (d[j] > d[k])
+				k = j;
+		t = d[i]; d[i] = d[k]; d[k] = t;
+		w[i] = d[i];
+		copy_dvector(v[i], z[k], n);
+		if (k != i)
+			copy_dvector(z[k], z[i], n);
+	}
+
+	free_dmatrix(z);
+	free_dvector(d);
+	free_dvector(e);
+	free_dvector(p);
+	free_dvector(beta);
+	free_dvector(cs);
+	free_dvector(sn);
+}
+
 /* dst = src1 + scale * src2	*/
 void scaleadd_dvector (double *dst, double *src1, double *src2, int n, double scale)
 {
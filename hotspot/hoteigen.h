@@ -0,0 +1,30 @@
+#ifndef __HOTEIGEN_H_
+#define __HOTEIGEN_H_
+
+#include "util.h"
+
+/* global configuration parameters for HotEigen	*/
+typedef struct global_config_t_st
+{
+	/* floorplan input file	*/
+	char flp_file[STR_SIZE];
+	/* eigen decomposition output file */
+	char eigen_file[STR_SIZE];
+	/* input configuration parameters from file	*/
+	char config[STR_SIZE];
+	/* output configuration parameters to file	*/
+	char dump_config[STR_SIZE];
+}global_config_t;
+
+/* 
+ * parse a table of name-value string pairs and add the configuration
+ * parameters to 'config'
+ */
+void global_config_from_strs(global_config_t *config, str_pair *table, int size);
+/* 
+ * convert config into a table of name-value pairs. returns the no.
+ * of parameters converted
+ */
+int global_config_to_strs(global_config_t *config, str_pair *table, int max_entries);
+
+#endif
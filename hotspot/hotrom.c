@@ -0,0 +1,172 @@
+/* 
+ * HotROM builds a reduced-order thermal model from a floorplan,
+ * for schedulers that need the steady state and transient response
+ * of floorplans too large for a dense thermal resistance matrix
+ * (e.g. thousands of cores). It sets up the block model, extracts
+ * its slowest thermal modes and stores them together with a sparse
+ * static correction for the remaining, fast modes. see 
+ * dump_reduced_model_block in temperature_block.c for the details.
+ */
+#include <stdio.h>
+#include <string.h>
+#ifdef _MSC_VER
+#define strcasecmp    _stricmp
+#define strncasecmp   _strnicmp
+#else
+#include <strings.h>
+#endif
+
+#include "flp.h"
+#include "temperature.h"
+#include "temperature_block.h"
+#include "util.h"
+#include "hotrom.h"
+
+void usage(int argc, char **argv)
+{
+	fprintf(stdout, "Usage: %s -f <file> -o <file> [-c <file>] [-d <file>] [-r <rank>] [-t <tol>] [options]\n", argv[0]);
+	fprintf(stdout, "Builds a reduced-order thermal model of the given floorplan.\n");
+	fprintf(stdout, "Options:(may be specified in any order, within \"[]\" means optional)\n");
+	fprintf(stdout, "   -f <file>\tfloorplan input file (e.g. ev6.flp)\n");
+	fprintf(stdout, "   -o <file>\treduced-order model output file\n");
+	fprintf(stdout, "  [-c <file>]\tinput configuration parameters from file (e.g. hotspot.config)\n");
+	fprintf(stdout, "  [-d <file>]\toutput configuration parameters to file\n");
+	fprintf(stdout, "  [-r <rank>]\tno. of thermal modes to keep (default %d)\n", DEFAULT_ROM_RANK);
+	fprintf(stdout, "  [-t <tol>]\tmax. error of the steady state, as a fraction of the temperature\n");
+	fprintf(stdout, "           \trise under uniform peak power (default %g, 0 keeps it exact)\n", DEFAULT_ROM_TOL);
+	fprintf(stdout, "  [options]\tzero or more options of the form \"-<name> <value>\",\n");
+	fprintf(stdout, "           \toverride the options from config file\n");
+}
+
+/* 
+ * parse a table of name-value string pairs and add the configuration
+ * parameters to 'config'
+ */
+void global_config_from_strs(global_config_t *config, str_pair *table, int size)
+{
+	int idx;
+	if ((idx = get_str_index(table, size, "f")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->flp_file) != 1)
+			fatal("invalid format for configuration  parameter flp_file\n");
+	} else {
+		fatal("required parameter flp_file missing. check usage\n");
+	}
+	if ((idx = get_str_index(table, size, "o")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->rom_file) != 1)
+			fatal("invalid format for configuration  parameter rom_file\n");
+	} else {
+		fatal("required parameter rom_file missing. check usage\n");
+	}
+	if ((idx = get_str_index(table, size, "c")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->config) != 1)
+			fatal("invalid format for configuration  parameter config\n");
+	} else {
+		strcpy(config->config, NULLFILE);
+	}
+	if ((idx = get_str_index(table, size, "d")) >= 0) {
+		if(sscanf(table[idx].value, "%s", config->dump_config) != 1)
+			fatal("invalid format for configuration  parameter dump_config\n");
+	} else {
+		strcpy(config->dump_config, NULLFILE);
+	}
+	if ((idx = get_str_index(table, size, "r")) >= 0) {
+		if(sscanf(table[idx].value, "%d", &config->rank) != 1)
+			fatal("invalid format for configuration  parameter rank\n");
+	} else {
+		config->rank = DEFAULT_ROM_RANK;
+	}
+	if ((idx = get_str_index(table, size, "t")) >= 0) {
+		if(sscanf(table[idx].value, "%lf", &config->tol) != 1)
+			fatal("invalid format for configuration  parameter tol\n");
+	} else {
+		config->tol = DEFAULT_ROM_TOL;
+	}
+	if (config->rank < 1)
+		fatal("rank should be greater than zero\n");
+	if (config->tol < 0)
+		fatal("tol should be non-negative\n");
+}
+
+/* 
+ * convert config into a table of name-value pairs. returns the no.
+ * of parameters converted
+ */
+int global_config_to_strs(global_config_t *config, str_pair *table, int max_entries)
+{
+	if (max_entries < 6)
+		fatal("not enough entries in table\n");
+
+	sprintf(table[0].name, "f");
+	sprintf(table[1].name, "o");
+	sprintf(table[2].name, "c");
+	sprintf(table[3].name, "d");
+	sprintf(table[4].name, "r");
+	sprintf(table[5].name, "t");
+
+	sprintf(table[0].value, "%s", config->flp_file);
+	sprintf(table[1].value, "%s", config->rom_file);
+	sprintf(table[2].value, "%s", config->config);
+	sprintf(table[3].value, "%s", config->dump_config);
+	sprintf(table[4].value, "%d", config->rank);
+	sprintf(table[5].value, "%lg", config->tol);
+
+	return 6;
+}
+
+/* main function for the reduced-order model builder	*/
+int main(int argc, char **argv)
+{
+	flp_t *flp;
+	RC_model_t *model;
+	thermal_config_t thermal_config;
+	global_config_t global_config;
+	str_pair table[MAX_ENTRIES];
+	int size;
+
+	if (!(argc >= 5 && argc % 2)) {
+		usage(argc, argv);
+		return 1;
+	}
+
+	size = parse_cmdline(table, MAX_ENTRIES, argc, argv);
+	global_config_from_strs(&global_config, table, size);
+
+	/* read configuration file	*/
+	if (strcmp(global_config.config, NULLFILE))
+		size += read_str_pairs(&table[size], MAX_ENTRIES, global_config.config);
+
+	/* 
+	 * in the str_pair 'table', earlier entries override later ones.
+	 * so, command line options have priority over config file 
+	 */
+	size = str_pairs_remove_duplicates(table, size);
+
+	/* get defaults */
+	thermal_config = default_thermal_config();
+	/* modify according to command line / config file	*/
+	thermal_config_add_from_strs(&thermal_config, table, size);
+
+	/* dump configuration if specified	*/
+	if (strcmp(global_config.dump_config, NULLFILE)) {
+		size = global_config_to_strs(&global_config, table, MAX_ENTRIES);
+		size += thermal_config_to_strs(&thermal_config, &table[size], MAX_ENTRIES-size);
+		/* prefix the name of the variable with a '-'	*/
+		dump_str_pairs(table, size, global_config.dump_config, "-");
+	}
+
+	/* the modes are those of the block model	*/
+	if (strcasecmp(thermal_config.model_type, BLOCK_MODEL_STR))
+		fatal("reduced-order models are built from the block model. use \"-model_type block\"\n");
+
+	flp = read_flp(global_config.flp_file, FALSE);
+	model = alloc_RC_model(&thermal_config, flp, 0);
+	populate_R_model(model, flp);
+	populate_C_model(model, flp);
+
+	dump_reduced_model_block(model->block, global_config.rank, global_config.tol, global_config.rom_file);
+
+	delete_RC_model(model);
+	free_flp(flp, FALSE);
+
+	return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef __HOTROM_H_
+#define __HOTROM_H_
+
+#include "util.h"
+
+/* defaults: no. of thermal modes and relative threshold of the static correction	*/
+#define DEFAULT_ROM_RANK	32
+#define DEFAULT_ROM_TOL		1.0e-2
+
+/* global configuration parameters for HotROM	*/
+typedef struct global_config_t_st
+{
+	/* floorplan input file	*/
+	char flp_file[STR_SIZE];
+	/* reduced-order model output file */
+	char rom_file[STR_SIZE];
+	/* input configuration parameters from file	*/
+	char config[STR_SIZE];
+	/* output configuration parameters to file	*/
+	char dump_config[STR_SIZE];
+	/* no. of thermal modes kept	*/
+	int rank;
+	/* static correction entries dropped per row add up to at most this fraction of its resistance	*/
+	double tol;
+}global_config_t;
+
+/* 
+ * parse a table of name-value string pairs and add the configuration
+ * parameters to 'config'
+ */
+void global_config_from_strs(global_config_t *config, str_pair *table, int size);
+/* 
+ * convert config into a table of name-value pairs. returns the no.
+ * of parameters converted
+ */
+int global_config_to_strs(global_config_t *config, str_pair *table, int max_entries);
+
+#endif
@@ -82,9 +82,13 @@ typedef struct thermal_config_t_st
 	char model_type[STR_SIZE];
 	int leakage_used;
 	int leakage_mode;
+	char leakage_power_file[STR_SIZE];
+	char leakage_beta_file[STR_SIZE];
+	double leakage_tref;
 	int package_model_used; /* flag to indicate whether package model is used */
 	char package_config_file[STR_SIZE]; /* package/fan configurations */ 
 	int block_omit_lateral;	/* omit lateral resistance?	*/
+	int block_exact_step;	/* step with the precomputed matrix exponential instead of rk4?	*/
 	int grid_rows;			/* grid resolution - no. of rows	*/
 	int grid_cols;			/* grid resolution - no. of cols	*/
 	char grid_layer_file[STR_SIZE];
@@ -112,6 +116,8 @@ typedef struct RC_model_t_st
 	};
 	int type;
 	thermal_config_t *config;
+	double *leak_power;
+	double *leak_beta;
 }RC_model_t;
 
 /* thermal model routines */
@@ -173,6 +179,16 @@ void read_temp (RC_model_t *model, double *temp, char *file, int clip);
  */ 
 void steady_state_temp(RC_model_t *model, double *power, double *temp);
 
+/* same as above for 'k' power vectors at once. power[i]
+ * and temp[i] must be allocated using 'hotspot_vector'.
+ * temp[i] will contain the steady state temperatures for
+ * power[i]. useful to evaluate several candidate power 
+ * distributions (e.g. task mappings) together. with the
+ * block model, the LU decomposition of the conductance
+ * matrix is shared by all of them
+ */ 
+void steady_state_temp_batch(RC_model_t *model, double **power, double **temp, int k);
+
 /* computation of the transient temperatures. 'power'
  * and 'temp' must be allocated using 'hotspot_vector'.
  * 'populate_R_model' and 'populate_C_model' must be
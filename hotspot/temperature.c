@@ -77,6 +77,9 @@ thermal_config_t default_thermal_config(void)
 	
 	config.leakage_used = 0;
 	config.leakage_mode = 0;
+	strcpy(config.leakage_power_file, NULLFILE);
+	strcpy(config.leakage_beta_file, NULLFILE);
+	config.leakage_tref = 330;	/* McPAT's temperature	*/
 	
 	config.package_model_used = 0;
 	strcpy(config.package_config_file, NULLFILE);	
@@ -86,6 +89,7 @@ thermal_config_t default_thermal_config(void)
 
 	/* block model specific parameters	*/
 	config.block_omit_lateral = FALSE;	/* omit lateral chip resistances?	*/
+	config.block_exact_step = FALSE;	/* closed-form stepping instead of rk4?	*/
 
 	/* grid model specific parameters	*/
 	config.grid_rows = 64;				/* grid resolution - no. of rows	*/
@@ -235,6 +239,15 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
 	if ((idx = get_str_index(table, size, "leakage_mode")) >= 0) 
 		if(sscanf(table[idx].value, "%d", &config->leakage_mode) != 1)
 			fatal("invalid format for configuration  parameter leakage_mode\n");
+	if ((idx = get_str_index(table, size, "leakage_power_file")) >= 0)
+		if(sscanf(table[idx].value, "%s", config->leakage_power_file) != 1)
+			fatal("invalid format for configuration  parameter leakage_power_file\n");
+	if ((idx = get_str_index(table, size, "leakage_beta_file")) >= 0)
+		if(sscanf(table[idx].value, "%s", config->leakage_beta_file) != 1)
+			fatal("invalid format for configuration  parameter leakage_beta_file\n");
+	if ((idx = get_str_index(table, size, "leakage_tref")) >= 0)
+		if(sscanf(table[idx].value, "%lf", &config->leakage_tref) != 1)
+			fatal("invalid format for configuration  parameter leakage_tref\n");
 	if ((idx = get_str_index(table, size, "package_model_used")) >= 0) 
 		if(sscanf(table[idx].value, "%d", &config->package_model_used) != 1)
 			fatal("invalid format for configuration  parameter package_model_used\n");
@@ -244,6 +257,9 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
 	if ((idx = get_str_index(table, size, "block_omit_lateral")) >= 0)
 		if(sscanf(table[idx].value, "%d", &config->block_omit_lateral) != 1)
 			fatal("invalid format for configuration  parameter block_omit_lateral\n");
+	if ((idx = get_str_index(table, size, "block_exact_step")) >= 0)
+		if(sscanf(table[idx].value, "%d", &config->block_exact_step) != 1)
+			fatal("invalid format for configuration  parameter block_exact_step\n");
 	if ((idx = get_str_index(table, size, "grid_rows")) >= 0)
 		if(sscanf(table[idx].value, "%d", &config->grid_rows) != 1)
 			fatal("invalid format for configuration  parameter grid_rows\n");
@@ -269,11 +285,9 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
 		(config->s_solder <= 0) || (config->t_solder <= 0) || (config->s_pcb <= 0) ||
 		(config->t_solder <= 0) || (config->r_convec_sec <= 0) || (config->c_convec_sec <= 0))
 		fatal("secondary heat tranfer layer dimensions should be greater than zero\n");
-	/* leakage iteration is not supported in transient mode in this release */
-	if (config->leakage_used == 1) {
-		printf("Warning: transient leakage iteration is not supported in this release...\n");
-		printf(" ...all transient results are without thermal-leakage loop.\n");
-	}		
+	if (config->leakage_used && config->leakage_mode == LEAKAGE_CURVES &&
+		(!strcmp(config->leakage_power_file, NULLFILE) || !strcmp(config->leakage_beta_file, NULLFILE)))
+		fatal("leakage_mode 2 needs leakage_power_file and leakage_beta_file\n");
 	if ((config->model_secondary == 1) && (!strcasecmp(config->model_type, BLOCK_MODEL_STR)))
 		fatal("secondary heat tranfer path is supported only in the grid mode\n");	
 	if ((config->thermal_threshold < 0) || (config->c_convec < 0) || 
@@ -298,7 +312,7 @@ void thermal_config_add_from_strs(thermal_config_t *config, str_pair *table, int
  */
 int thermal_config_to_strs(thermal_config_t *config, str_pair *table, int max_entries)
 {
-	if (max_entries < 49)
+	if (max_entries < 53)
 		fatal("not enough entries in table\n");
 
 	sprintf(table[0].name, "t_chip");
@@ -350,6 +364,10 @@ int thermal_config_to_strs(thermal_config_t *config, str_pair *table, int max_en
 	sprintf(table[46].name, "grid_layer_file");
 	sprintf(table[47].name, "grid_steady_file");
 	sprintf(table[48].name, "grid_map_mode");
+	sprintf(table[49].name, "block_exact_step");
+	sprintf(table[50].name, "leakage_power_file");
+	sprintf(table[51].name, "leakage_beta_file");
+	sprintf(table[52].name, "leakage_tref");
 
 	sprintf(table[0].value, "%lg", config->t_chip);
 	sprintf(table[1].value, "%lg", config->k_chip);
@@ -400,8 +418,12 @@ int thermal_config_to_strs(thermal_config_t *config, str_pair *table, int max_en
 	sprintf(table[46].value, "%s", config->grid_layer_file);
 	sprintf(table[47].value, "%s", config->grid_steady_file);
 	sprintf(table[48].value, "%s", config->grid_map_mode);
+	sprintf(table[49].value, "%d", config->block_exact_step);
+	sprintf(table[50].value, "%s", config->leakage_power_file);
+	sprintf(table[51].value, "%s", config->leakage_beta_file);
+	sprintf(table[52].value, "%lg", config->leakage_tref);
 
-	return 49;
+	return 53;
 }
 
 /* package parameter routines	*/
@@ -589,6 +611,15 @@ void populate_R_model(RC_model_t *model, flp_t *flp)
 	else if (model->type == GRID_MODEL)	
 		populate_R_model_grid(model->grid, flp);
 	else fatal("unknown model type\n");	
+
+	/* read the leakage curves once the units are known	*/
+	if (model->config->leakage_used && model->config->leakage_mode == LEAKAGE_CURVES 
+		&& !model->leak_power) {
+		model->leak_power = hotspot_vector(model);
+		model->leak_beta = hotspot_vector(model);
+		read_power(model, model->leak_power, model->config->leakage_power_file);
+		read_power(model, model->leak_beta, model->config->leakage_beta_file);
+	}
 }
 
 /* populate the thermal capacitance values */
@@ -632,7 +663,7 @@ void steady_state_temp(RC_model_t *model, double *power, double *temp)
 				for(i=0; i < n; i++) {
 					blk_height = model->block->flp->units[i].height;
 					blk_width = model->block->flp->units[i].width;
-					power_new[i] = power[i] + calc_leakage(model->config->leakage_mode,blk_height,blk_width,temp[i]);
+					power_new[i] = power[i] + unit_leakage(model,i,blk_height,blk_width,temp[i]);
 					temp_old[i] = temp[i]; //copy temp before update
 				}
 				steady_state_temp_block(model->block, power_new, temp); // update temperature
@@ -670,7 +701,7 @@ void steady_state_temp(RC_model_t *model, double *power, double *temp)
 						for(j=0; j < model->grid->layers[k].flp->n_units; j++) {
 							blk_height = model->grid->layers[k].flp->units[j].height;
 							blk_width = model->grid->layers[k].flp->units[j].width;
-							power_new[base+j] = power[base+j] + calc_leakage(model->config->leakage_mode,blk_height,blk_width,temp[base+j]);
+							power_new[base+j] = power[base+j] + unit_leakage(model,base+j,blk_height,blk_width,temp[base+j]);
 							temp_old[base+j] = temp[base+j]; //copy temp before update
 						}
 					base += model->grid->layers[k].flp->n_units;	
@@ -705,10 +736,102 @@ void steady_state_temp(RC_model_t *model, double *power, double *temp)
 	else fatal("unknown model type\n");	
 }
 
+/* steady state temperatures for 'k' power vectors at once	*/
+void steady_state_temp_batch(RC_model_t *model, double **power, double **temp, int k)
+{
+	int i;
+
+	/* the temperature-leakage loop iterates each power vector separately	*/
+	if (model->config->leakage_used) {
+		for(i=0; i < k; i++)
+			steady_state_temp(model, power[i], temp[i]);
+	} else if (model->type == BLOCK_MODEL)
+		steady_state_temp_batch_block(model->block, power, temp, k);
+	else if (model->type == GRID_MODEL)	{
+		/* the multigrid solver has no factorization to share	*/
+		for(i=0; i < k; i++)
+			steady_state_temp_grid(model->grid, power[i], temp[i]);
+	}
+	else fatal("unknown model type\n");	
+}
+
+/* transient temperature with the temperature-leakage loop. the leakage 
+ * during the interval depends on the temperature at its end. so, the 
+ * interval is solved again from the same starting temperatures with 
+ * the leakage of the latest estimate until the estimate converges. with
+ * -block_exact_step, each iteration is just two matrix-vector products.
+ * the grid model carries its internal temperatures across calls and 
+ * cannot restart the interval. so, it uses the leakage at the starting
+ * temperatures instead
+ */
+void compute_temp_leakage(RC_model_t *model, double *power, double *temp, double time_elapsed)
+{
+	int leak_convg_true = 0;
+	int leak_iter = 0;
+	int n, base=0;
+	double blk_height, blk_width;
+	int i, j, k;
+	
+	double *temp_start = NULL;
+	double *temp_old = NULL;
+	double *power_new = NULL;
+	double *temp_grid = NULL;
+	double d_max=0.0;
+
+	power_new = hotspot_vector(model);
+
+	if (model->type == BLOCK_MODEL) {
+		n = model->block->flp->n_units;
+		temp_start = hotspot_vector(model);
+		temp_old = hotspot_vector(model);
+		copy_dvector(temp_start, temp, model->block->n_nodes);
+		for (leak_iter=0;(!leak_convg_true)&&(leak_iter<=LEAKAGE_MAX_ITER);leak_iter++){
+			for(i=0; i < n; i++) {
+				blk_height = model->block->flp->units[i].height;
+				blk_width = model->block->flp->units[i].width;
+				power_new[i] = power[i] + unit_leakage(model,i,blk_height,blk_width,temp[i]);
+				temp_old[i] = temp[i]; //copy the estimate before update
+			}
+			copy_dvector(temp, temp_start, model->block->n_nodes);
+			compute_temp_block(model->block, power_new, temp, time_elapsed);
+			d_max = 0.0;
+			for(i=0; i < n; i++)
+				d_max = MAX(d_max, fabs(temp[i] - temp_old[i]));
+			if (d_max < LEAK_TOL) // check convergence
+				leak_convg_true = 1;
+			if (d_max > TEMP_HIGH && leak_iter > 1) // check to make sure d_max is not "nan"
+				fatal("temperature is too high, possible thermal runaway. Double-check power inputs and package settings.\n");
+		}
+		free_dvector(temp_start);
+		free_dvector(temp_old);
+		/* if no convergence after max number of iterations, thermal runaway */
+		if (!leak_convg_true)
+			fatal("too many iterations before temperature-leakage convergence -- possible thermal runaway\n");
+	} else if (model->type == GRID_MODEL) {
+		/* 'temp' is NULL when the grid model reuses the temperatures of the last call	*/
+		temp_grid = temp ? temp : model->grid->last_temp;
+		for(k=0, base=0; k < model->grid->n_layers; k++) {
+			if(model->grid->layers[k].has_power)
+				for(j=0; j < model->grid->layers[k].flp->n_units; j++) {
+					blk_height = model->grid->layers[k].flp->units[j].height;
+					blk_width = model->grid->layers[k].flp->units[j].width;
+					power_new[base+j] = power[base+j] + unit_leakage(model,base+j,blk_height,blk_width,temp_grid[base+j]);
+				}
+			base += model->grid->layers[k].flp->n_units;	
+		}
+		compute_temp_grid(model->grid, power_new, temp, time_elapsed);
+	}
+	else fatal("unknown model type\n");	
+
+	free_dvector(power_new);
+}
+
 /* transient (instantaneous) temperature	*/
 void compute_temp(RC_model_t *model, double *power, double *temp, double time_elapsed)
 {
-	if (model->type == BLOCK_MODEL)
+	if (model->config->leakage_used)
+		compute_temp_leakage(model, power, temp, time_elapsed);
+	else if (model->type == BLOCK_MODEL)
 		compute_temp_block(model->block, power, temp, time_elapsed);
 	else if (model->type == GRID_MODEL)	
 		compute_temp_grid(model->grid, power, temp, time_elapsed);
@@ -881,6 +1004,20 @@ double calc_leakage(int mode, double h, double w, double temp)
 	return leakage_power;	
 }
 
+/* leakage power of unit 'idx' of the model at temperature 'temp'. with the 
+ * leakage curves, the power trace already has the static power at leakage_tref. 
+ * so, only the difference to it is returned
+ */
+double unit_leakage(RC_model_t *model, int idx, double h, double w, double temp)
+{
+	thermal_config_t *config = model->config;
+
+	if (config->leakage_mode != LEAKAGE_CURVES)
+		return calc_leakage(config->leakage_mode, h, w, temp);
+
+	return model->leak_power[idx] * (exp(model->leak_beta[idx] * (temp - config->leakage_tref)) - 1);
+}
+
 /* destructor */
 void delete_RC_model(RC_model_t *model)
 {
@@ -889,5 +1026,9 @@ void delete_RC_model(RC_model_t *model)
 	else if (model->type == GRID_MODEL)	
 		delete_grid_model(model->grid);
 	else fatal("unknown model type\n");	
+	if (model->leak_power) {
+		free_dvector(model->leak_power);
+		free_dvector(model->leak_beta);
+	}
 	free(model);
 }
@@ -26,6 +26,8 @@
 /* temperature-leakage loop constants */
 #define LEAKAGE_MAX_ITER 100 /* max thermal-leakage iteration number, if exceeded, report thermal runaway*/
 #define LEAK_TOL	0.01 /* thermal-leakage temperature convergence criterion */
+/* leakage mode with per-unit exponential curves, e.g. fitted from McPAT	*/
+#define LEAKAGE_CURVES	2
 
 /* number of extra nodes due to the model:
  * 4 spreader nodes, 4 heat sink nodes under
@@ -115,6 +117,19 @@
 
 /* constants related to transient temperature calculation	*/
 #define MIN_STEP	1e-7	/* 0.1 us	*/
+/* matrix exponential for exact stepping: taylor terms and max. norm of the scaled matrix	*/
+#define EXP_TERMS	12
+#define EXP_MAX_NORM	0.5
+/* symmetric eigen decompositions: max. no. of QL iterations per eigenvalue,	*/
+/* min. order to run in parallel and no. of columns per thread in the QL sweeps	*/
+#define EIG_MAX_ITER	100
+#define EIG_PARALLEL_MIN	256
+#define EIG_BLOCK	64
+/* dense kernels without math acceleration: tile size, no. of columns accumulated in	*/
+/* registers and min. order to run in parallel	*/
+#define MAT_BLOCK	64
+#define MAT_STRIP	16
+#define MAT_PARALLEL_MIN	256
 
 /* BLAS/LAPACK definitions	*/
 #define MA_NONE		0 
@@ -195,6 +210,12 @@ typedef struct thermal_config_t_st
 	/* temperature-leakage loop */
 	int leakage_used;
 	int leakage_mode;
+	/* leakage curves (leakage_mode 2): per-unit static power at 
+	 * leakage_tref and its exponential temperature coefficient
+	 */
+	char leakage_power_file[STR_SIZE];
+	char leakage_beta_file[STR_SIZE];
+	double leakage_tref;
 	
 	/* package model */
 	int package_model_used; /* flag to indicate whether package model is used */
@@ -202,6 +223,7 @@ typedef struct thermal_config_t_st
 
 	/* parameters specific to block model	*/
 	int block_omit_lateral;	/* omit lateral resistance?	*/
+	int block_exact_step;	/* step with the precomputed matrix exponential instead of rk4?	*/
 
 	/* parameters specific to grid model	*/
 	int grid_rows;			/* grid resolution - no. of rows	*/
@@ -350,6 +372,9 @@ typedef struct RC_model_t_st
 	/* block model or grid model	*/
 	int type;
 	thermal_config_t *config;
+	/* leakage curves (leakage_mode 2), NULL until read	*/
+	double *leak_power;
+	double *leak_beta;
 }RC_model_t;
 
 /* constructor/destructor	*/
@@ -363,6 +388,8 @@ void populate_C_model(RC_model_t *model, flp_t *flp);
 
 /* hotspot main interfaces - temperature.c	*/
 void steady_state_temp(RC_model_t *model, double *power, double *temp);
+/* steady state temperatures for 'k' power vectors power[0..k-1] at once	*/
+void steady_state_temp_batch(RC_model_t *model, double **power, double **temp, int k);
 void compute_temp(RC_model_t *model, double *power, double *temp, double time_elapsed);
 /* differs from 'dvector()' in that memory for internal nodes is also allocated	*/
 double *hotspot_vector(RC_model_t *model);
@@ -396,11 +423,19 @@ double getcap(double sp_heat, double thickness, double area);
 
 /* LU forward and backward substitution	*/
 void lusolve(double **a, int n, int *p, double *b, double *x, int spd);
+/* same as above for 'k' right hand sides b[0..k-1]	*/
+void lusolve_multi(double **a, int n, int *p, double **b, double **x, int k, int spd);
+/* inv = m^-1 from the lu decomposition 'a' of m	*/
+void luinv(double **a, int n, int *p, double **inv, int spd);
 
 /* 4th order Runge Kutta solver with adaptive step sizing */
 double rk4(void *model, double *y, void *p, int n, double *h, double *yout, slope_fn_ptr f);
 
-/* matrix and vector routines	*/
+/* 
+ * matrix and vector routines. matrices are contiguous and row-major
+ * (as from dmatrix). without math acceleration, they are cache-blocked,
+ * vectorized and multithreaded with OpenMP
+ */
 void matmult(double **c, double **a, double **b, int n);
 /* same as above but 'a' is a diagonal matrix stored as a 1-d array	*/
 void diagmatmult(double **c, double *a, double **b, int n); 
@@ -413,12 +448,26 @@ void diagmatvectmult(double *vout, double *m, double *vin, int n);
  * and positive definite 
  */
 void matinv(double **inv, double **m, int n, int spd);
+/* 
+ * e = exp(m), e, m are n by n matrices. computed by
+ * scaling and squaring with a truncated taylor series
+ */
+void matexp(double **e, double **m, int n);
+/* 
+ * a = v^T * diag(w) * v for a symmetric n by n matrix a, with
+ * the eigenvectors in the rows of v sorted by decreasing eigenvalue.
+ * a is destroyed. householder tridiagonalization and implicit QL,
+ * multithreaded with OpenMP for large n
+ */
+void symeig(double **a, int n, double *w, double **v);
 
 /* dst = src1 + scale * src2	*/
 void scaleadd_dvector (double *dst, double *src1, double *src2, int n, double scale);
 
 /* temperature-aware leakage calculation */
 double calc_leakage(int mode, double h, double w, double temp);
+/* same as above for unit 'idx' of the model, including the leakage curves	*/
+double unit_leakage(RC_model_t *model, int idx, double h, double w, double temp);
 
 /* calculate average heatsink temperature for natural convection package model */
 double calc_sink_temp(RC_model_t *model, double *temp);
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include <string.h>
 #ifdef _MSC_VER
 #define strcasecmp    _stricmp
@@ -43,6 +44,7 @@ block_model_t *alloc_block_model(thermal_config_t *config, flp_t *placeholder)
 	/* vertical conductances to ambient	*/
 	model->g_amb = dvector(n+EXTRA);
 	model->t_vector = dvector(m);/* scratch pad	*/
+	model->t_exact = dvector(m);/* scratch pad for closed-form stepping	*/
 	model->p = ivector(m);		/* permutation vector for b's LUP decomposition	*/
 
 	model->a = dvector(m);		/* vertical Cs - diagonal matrix stored as a 1-d vector	*/
@@ -51,6 +53,9 @@ block_model_t *alloc_block_model(thermal_config_t *config, flp_t *placeholder)
 	model->b = dmatrix(m, m);
 	model->c = dmatrix(m, m);
 	model->lu = dmatrix(m, m);
+	/* phi and gamma are only needed for closed-form stepping	*/
+	model->phi = NULL;
+	model->gamma = NULL;
 
 	model->flp = placeholder;
 	return model;
@@ -292,6 +297,8 @@ void populate_R_model_block(block_model_t *model, flp_t *flp)
 	/* done	*/
 	model->flp = flp;
 	model->r_ready = TRUE;
+	/* phi and gamma have to be recomputed	*/
+	model->exact_step = 0;
 }
 
 /* creates 2 matrices: invA, C: dT + A^-1*BT = A^-1*Power, 
@@ -376,6 +383,8 @@ void populate_C_model_block(block_model_t *model, flp_t *flp)
 
 	/*	done	*/
 	model->c_ready = TRUE;
+	/* phi and gamma have to be recomputed	*/
+	model->exact_step = 0;
 }
 
 /* setting package nodes' power numbers	*/
@@ -410,6 +419,23 @@ void steady_state_temp_block(block_model_t *model, double *power, double *temp)
 	lusolve(model->lu, model->n_nodes, model->p, power, temp, 1);
 }
 
+/* same as above for 'k' power vectors. all of them are solved 
+ * together with the same LUP decomposition of B
+ */
+void steady_state_temp_batch_block(block_model_t *model, double **power, double **temp, int k)
+{
+	int i;
+
+	if (!model->r_ready)
+		fatal("R model not ready\n");
+
+	/* set power numbers for the virtual nodes */
+	for (i = 0; i < k; i++)
+		set_internal_power_block(model, power[i]);
+
+	lusolve_multi(model->lu, model->n_nodes, model->p, power, temp, k, 1);
+}
+
 /* compute the slope vector dy for the transient equation 
  * dy + cy = p. useful in the transient solver
  */
@@ -441,6 +467,58 @@ void slope_fn_block(block_model_t *model, double *y, double *p, double *dy)
 	#endif
 }
 
+/* the RC network is linear and time-invariant. so, the solution of
+ * dT + CT = inv_A * Power with constant power over a step of 'h' is 
+ * T(t+h) = phi * T(t) + gamma * Power, where phi = exp(-C*h) and
+ * gamma = inv_C * (I - phi) * inv_A = (I - phi) * inv_B (since 
+ * inv_C commutes with phi). compute phi and gamma for a step of 'h'
+ */
+void compute_exact_step_block(block_model_t *model, double h)
+{
+	/* shortcuts	*/
+	int n = model->n_nodes;
+	double **phi, **gamma;
+	double **invb, **t;
+	int i, j;
+
+	/* allocated on the first closed-form step	*/
+	if (!model->phi) {
+		model->phi = dmatrix(n, n);
+		model->gamma = dmatrix(n, n);
+	}
+	phi = model->phi;
+	gamma = model->gamma;
+
+	invb = dmatrix(n, n);
+	t = dmatrix(n, n);
+
+	/* phi = exp(-C*h)	*/
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			t[i][j] = -h * model->c[i][j];
+	matexp(phi, t, n);
+
+	/* inv_B from the LUP decomposition of B	*/
+	for (j = 0; j < n; j++) {
+		zero_dvector(model->t_vector, n);
+		model->t_vector[j] = 1.0;
+		lusolve(model->lu, n, model->p, model->t_vector, model->t_exact, 1);
+		for (i = 0; i < n; i++)
+			invb[i][j] = model->t_exact[i];
+	}
+
+	/* gamma = (I - phi) * inv_B	*/
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			t[i][j] = (i == j) - phi[i][j];
+	matmult(gamma, t, invb, n);
+
+	free_dmatrix(invb);
+	free_dmatrix(t);
+
+	model->exact_step = h;
+}
+
 /* compute_temp: solve for temperature from the equation dT + CT = inv_A * Power 
  * Given the temperature (temp) at time t, the power dissipation per cycle during the 
  * last interval (time_elapsed), find the new temperature at time t+time_elapsed.
@@ -462,6 +540,17 @@ void compute_temp_block(block_model_t *model, double *power, double *temp, doubl
 	/* set power numbers for the virtual nodes */
 	set_internal_power_block(model, power);
 
+	/* closed-form step: two matrix-vector products	*/
+	if (model->config.block_exact_step) {
+		if (model->exact_step != time_elapsed)
+			compute_exact_step_block(model, time_elapsed);
+		/* temp = phi * temp + gamma * POWER	*/
+		matvectmult(model->t_exact, model->phi, temp, model->n_nodes);
+		matvectmult(model->t_vector, model->gamma, power, model->n_nodes);
+		scaleadd_dvector(temp, model->t_exact, model->t_vector, model->n_nodes, 1.0);
+		return;
+	}
+
 	/* use the scratch pad vector to find (inv_A)*POWER */
 	diagmatvectmult(model->t_vector, model->inva, power, model->n_nodes);
 
@@ -519,6 +608,14 @@ void resize_thermal_model_block(block_model_t *model, int n_units)
 	resize_dmatrix(model->b, model->n_nodes, model->n_nodes);
 	resize_dmatrix(model->c, model->n_nodes, model->n_nodes);
 	resize_dmatrix(model->lu, model->n_nodes, model->n_nodes);
+	/* phi and gamma are reallocated at the new size on the next closed-form step	*/
+	if (model->phi) {
+		free_dmatrix(model->phi);
+		free_dmatrix(model->gamma);
+		model->phi = NULL;
+		model->gamma = NULL;
+	}
+	model->exact_step = 0;
 }
 
 /* sets the temperature of a vector 'temp' allocated using 'hotspot_vector'	*/
@@ -830,6 +927,222 @@ double calc_sink_temp_block(block_model_t *model, double *temp, thermal_config_t
 	return (sum / sink_size);
 }
 
+/* orthonormalize the rows of the m by n matrix w (modified gram-schmidt, twice)	*/
+static void orthonormalize_rows(double **w, int m, int n)
+{
+	double dot;
+	int i, k, l, pass;
+
+	for (pass = 0; pass < 2; pass++)
+		for (k = 0; k < m; k++) {
+			for (l = 0; l < k; l++) {
+				for (dot = 0, i = 0; i < n; i++)
+					dot += w[k][i] * w[l][i];
+				for (i = 0; i < n; i++)
+					w[k][i] -= dot * w[l][i];
+			}
+			for (dot = 0, i = 0; i < n; i++)
+				dot += w[k][i] * w[k][i];
+			if (dot == 0.0)
+				fatal("rank deficient subspace in model reduction\n");
+			for (dot = 1.0 / sqrt(dot), i = 0; i < n; i++)
+				w[k][i] *= dot;
+		}
+}
+
+static int compare_dbl(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+/* z = d * b^-1 * d * w for the rows of w, d is diagonal	*/
+static void scaled_inverse_block(block_model_t *model, double *d, double **w, double **y, double **z, int m)
+{
+	int i, k, n = model->n_nodes;
+
+	for (k = 0; k < m; k++)
+		for (i = 0; i < n; i++)
+			y[k][i] = d[i] * w[k][i];
+	lusolve_multi(model->lu, n, model->p, y, z, m, 1);
+	for (k = 0; k < m; k++)
+		for (i = 0; i < n; i++)
+			z[k][i] *= d[i];
+}
+
+/* 
+ * write a reduced-order model of the silicon layer to 'file': the 'rank'
+ * slowest thermal modes plus a sparse static correction for the rest.
+ * with b*v = mu*a*v and the modes normalized as v^T*a*v = 1, the thermal
+ * resistances between the blocks are the sum of v*v^T/mu over all modes.
+ * the slowest modes are found by subspace iteration on a^0.5*b^-1*a^0.5,
+ * whose eigenvalues are the time constants 1/mu. the fast modes are taken
+ * to respond instantaneously: their part of the resistance matrix is kept
+ * sparse by dropping the smallest entries of each row, as long as these add
+ * up to at most 'tol' times the row's total resistance. so, no temperature 
+ * is off by more than that fraction of its rise under uniform peak power.
+ * binary layout: ROM_MAGIC, n_units, rank, the unit names one per line,
+ * the time constants, the n_units by rank silicon part of the modes, the
+ * no. of correction entries and the correction in compressed sparse rows
+ * (row starts, columns, values)
+ */
+void dump_reduced_model_block(block_model_t *model, int rank, double tol, char *file)
+{
+	int n = model->n_nodes, nu = model->n_units;
+	int m = MIN(rank + MAX(ROM_GUARD, rank / 2), n);
+	double **w, **y, **z, **h, **q, **modes;
+	double *d, *tau, *old, *col, *x, *res, *mag, *vals, dot, budget;
+	unsigned int *start, *cols, value;
+	int i, j, k, l, iter, converged, nnz, drop;
+	char str[STR_SIZE];
+	FILE *fp;
+
+	if (!model->r_ready || !model->c_ready)
+		fatal("R and C models must be ready for model reduction\n");
+	if (rank < 1 || rank > n)
+		fatal("invalid rank for model reduction\n");
+
+	d = dvector(n);
+	for (i = 0; i < n; i++)
+		d[i] = sqrt(model->a[i]);
+
+	w = dmatrix(m, n);
+	y = dmatrix(m, n);
+	z = dmatrix(m, n);
+	h = dmatrix(m, m);
+	q = dmatrix(m, m);
+	tau = dvector(m);
+	old = dvector(m);
+	zero_dvector(old, m);
+
+	/* start from disjoint sets of nodes	*/
+	zero_dmatrix(w, m, n);
+	for (i = 0; i < n; i++)
+		w[i % m][i] = 1.0;
+	orthonormalize_rows(w, m, n);
+
+	/* 
+	 * subspace iteration with rayleigh-ritz projection. the extra 
+	 * guard vectors speed up convergence of the wanted modes
+	 */
+	for (iter = 0; ; iter++) {
+		scaled_inverse_block(model, d, w, y, z, m);
+		for (k = 0; k < m; k++)
+			for (l = 0; l <= k; l++) {
+				for (dot = 0, i = 0; i < n; i++)
+					dot += w[k][i] * z[l][i] + w[l][i] * z[k][i];
+				h[k][l] = h[l][k] = 0.5 * dot;
+			}
+		symeig(h, m, tau, q);
+
+		for (converged = (iter > 0), k = 0; k < rank; k++)
+			if (fabs(tau[k] - old[k]) > ROM_TOL * tau[k])
+				converged = FALSE;
+		if (converged)
+			break;
+		if (iter == ROM_MAX_ITER) {
+			warning("model reduction did not converge, the static correction makes up for it\n");
+			break;
+		}
+		copy_dvector(old, tau, m);
+
+		/* next basis: the images of the ritz vectors	*/
+		for (k = 0; k < m; k++)
+			for (i = 0; i < n; i++)
+				for (y[k][i] = 0, l = 0; l < m; l++)
+					y[k][i] += q[k][l] * z[l][i];
+		copy_dmatrix(w, y, m, n);
+		orthonormalize_rows(w, m, n);
+	}
+
+	/* silicon part of the modes: ritz vectors scaled back by a^-0.5	*/
+	modes = dmatrix(nu, rank);
+	for (i = 0; i < nu; i++)
+		for (k = 0; k < rank; k++) {
+			for (dot = 0, l = 0; l < m; l++)
+				dot += q[k][l] * w[l][i];
+			modes[i][k] = dot / d[i];
+		}
+
+	/* static correction from the exact resistances, one column at a time	*/
+	col = dvector(n);
+	x = dvector(n);
+	res = dvector(nu);
+	mag = dvector(nu);
+	start = (unsigned int *) calloc(nu + 1, sizeof(unsigned int));
+	cols = (unsigned int *) calloc(nu * nu, sizeof(unsigned int));
+	vals = dvector(nu * nu);
+	if (!start || !cols)
+		fatal("memory allocation error\n");
+	for (nnz = 0, j = 0; j < nu; j++) {
+		zero_dvector(col, n);
+		col[j] = 1.0;
+		lusolve(model->lu, n, model->p, col, x, 1);
+		/* the resistances are symmetric: column j is row j	*/
+		for (budget = 0, i = 0; i < nu; i++) {
+			for (res[i] = x[i], k = 0; k < rank; k++)
+				res[i] -= modes[j][k] * tau[k] * modes[i][k];
+			mag[i] = fabs(res[i]);
+			budget += x[i];
+		}
+		budget *= tol;
+		qsort(mag, nu, sizeof(double), compare_dbl);
+		for (drop = 0; drop < nu && mag[drop] <= budget; drop++)
+			budget -= mag[drop];
+		start[j] = nnz;
+		for (i = 0; drop < nu && i < nu; i++)
+			if (fabs(res[i]) >= mag[drop]) {
+				cols[nnz] = i;
+				vals[nnz++] = res[i];
+			}
+	}
+	start[nu] = nnz;
+
+	fp = fopen(file, "wb");
+	if (!fp) {
+		sprintf (str,"error: %s could not be opened for writing\n", file);
+		fatal(str);
+	}
+	value = ROM_MAGIC;
+	fwrite(&value, sizeof(value), 1, fp);
+	value = nu;
+	fwrite(&value, sizeof(value), 1, fp);
+	value = rank;
+	fwrite(&value, sizeof(value), 1, fp);
+	for (i = 0; i < nu; i++)
+		fprintf(fp, "%s\n", model->flp->units[i].name);
+	fwrite(tau, sizeof(double), rank, fp);
+	for (i = 0; i < nu; i++)
+		fwrite(modes[i], sizeof(double), rank, fp);
+	value = nnz;
+	fwrite(&value, sizeof(value), 1, fp);
+	fwrite(start, sizeof(unsigned int), nu + 1, fp);
+	fwrite(cols, sizeof(unsigned int), nnz, fp);
+	fwrite(vals, sizeof(double), nnz, fp);
+	if (ferror(fp)) {
+		sprintf (str,"error: %s could not be written\n", file);
+		fatal(str);
+	}
+	fclose(fp);
+
+	free_dvector(d);
+	free_dvector(tau);
+	free_dvector(old);
+	free_dvector(col);
+	free_dvector(x);
+	free_dvector(res);
+	free_dvector(mag);
+	free_dvector(vals);
+	free(start);
+	free(cols);
+	free_dmatrix(w);
+	free_dmatrix(y);
+	free_dmatrix(z);
+	free_dmatrix(h);
+	free_dmatrix(q);
+	free_dmatrix(modes);
+}
+
 void delete_block_model(block_model_t *model)
 {
 	free_dvector(model->a);
@@ -847,11 +1160,16 @@ void delete_block_model(block_model_t *model)
 	free_dvector(model->gy_hs);
 	free_dvector(model->g_amb);
 	free_dvector(model->t_vector);
+	free_dvector(model->t_exact);
 	free_ivector(model->p);
 
 	free_dmatrix(model->len);
 	free_dmatrix(model->g);
 	free_dmatrix(model->lu);
+	if (model->phi) {
+		free_dmatrix(model->phi);
+		free_dmatrix(model->gamma);
+	}
 
 	free_imatrix(model->border);
 
@@ -881,3 +1199,91 @@ void debug_print_block(block_model_t *model)
 	dump_dvector(model->g_amb, model->n_units+EXTRA);
 }
 
+
+/* 
+ * write the full eigen decomposition of the block model to 'file', in
+ * the layout read by the thermal model of the scheduler: the no. of
+ * units, ambient-connected nodes and nodes, the unit names and then
+ * b^-1, g_amb, the eigenvalues, eigenvectors and their inverse of
+ * A = -a^-1 * b, a, b and A. with D = a^0.5, the symmetric
+ * D^-1 * b * D^-1 = W^T * diag(l) * W gives eigenvalues -l,
+ * eigenvectors D^-1 * W^T and their inverse W * D. the eigenvalues
+ * are written most negative first, with the eigenvectors in the same
+ * order (earlier models list them unsorted)
+ */
+void dump_eigendata_block(block_model_t *model, char *file)
+{
+	int n = model->n_nodes, nu = model->n_units;
+	double **binv, **k, **v, *d, *l, *row;
+	unsigned int value;
+	int i, j;
+	char str[STR_SIZE];
+	FILE *fp;
+
+	if (!model->r_ready || !model->c_ready)
+		fatal("R and C models must be ready for the eigen decomposition\n");
+
+	fp = fopen(file, "wb");
+	if (!fp) {
+		sprintf (str,"error: %s could not be opened for writing\n", file);
+		fatal(str);
+	}
+	value = nu;
+	fwrite(&value, sizeof(value), 1, fp);
+	value = nu + EXTRA;
+	fwrite(&value, sizeof(value), 1, fp);
+	value = n;
+	fwrite(&value, sizeof(value), 1, fp);
+	for (i = 0; i < nu; i++)
+		fprintf(fp, "%s\n", model->flp->units[i].name);
+
+	binv = dmatrix(n, n);
+	luinv(model->lu, n, model->p, binv, 1);
+	fwrite(binv[0], sizeof(double), n * n, fp);
+	free_dmatrix(binv);
+	fwrite(model->g_amb, sizeof(double), nu + EXTRA, fp);
+
+	d = dvector(n);
+	for (i = 0; i < n; i++)
+		d[i] = sqrt(model->a[i]);
+	k = dmatrix(n, n);
+	for (i = 0; i < n; i++)
+		for (j = 0; j < n; j++)
+			k[i][j] = model->b[i][j] / (d[i] * d[j]);
+	v = dmatrix(n, n);
+	l = dvector(n);
+	symeig(k, n, l, v);
+	free_dmatrix(k);
+
+	row = dvector(n);
+	for (i = 0; i < n; i++)
+		row[i] = -l[i];
+	fwrite(row, sizeof(double), n, fp);
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < n; j++)
+			row[j] = v[j][i] / d[i];
+		fwrite(row, sizeof(double), n, fp);
+	}
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < n; j++)
+			row[j] = v[i][j] * d[j];
+		fwrite(row, sizeof(double), n, fp);
+	}
+	fwrite(model->a, sizeof(double), n, fp);
+	fwrite(model->b[0], sizeof(double), n * n, fp);
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < n; j++)
+			row[j] = -model->b[i][j] / model->a[i];
+		fwrite(row, sizeof(double), n, fp);
+	}
+	if (ferror(fp)) {
+		sprintf (str,"error: %s could not be written\n", file);
+		fatal(str);
+	}
+	fclose(fp);
+
+	free_dvector(d);
+	free_dvector(l);
+	free_dvector(row);
+	free_dmatrix(v);
+}
@@ -14,6 +14,15 @@
 /* heat sink */
 #define HSINK 3
 
+/* reduced-order model: file tag ("TROM"), min. no. of extra subspace
+ * vectors, max. no. of subspace iterations and relative time constant
+ * tolerance
+ */
+#define ROM_MAGIC	0x4d4f5254
+#define ROM_GUARD	8
+#define ROM_MAX_ITER	1000
+#define ROM_TOL		1.0e-6
+
 /* block thermal model	*/
 typedef struct block_model_t_st
 {
@@ -35,6 +44,12 @@ typedef struct block_model_t_st
 	double *inva;
 	/* c = inva * b	*/
 	double **c;
+	/* closed-form stepping over 'exact_step' seconds: 
+	 * T(t+exact_step) = phi * T(t) + gamma * POWER, 
+	 * phi = exp(-c * exact_step), gamma = (I - phi) * inv(b)
+	 */
+	double **phi, **gamma;	/* NULL until the first closed-form step	*/
+	double exact_step;	/* 0 if phi and gamma are not computed	*/
 
 	/* package parameters	*/
 	package_RC_t pack;
@@ -46,6 +61,7 @@ typedef struct block_model_t_st
 	double *gx_hs, *gy_hs;
 	double *g_amb;
 	double *t_vector;
+	double *t_exact;
 	double **len, **g;
 	int **border;
 
@@ -72,6 +88,7 @@ void populate_C_model_block(block_model_t *model, flp_t *flp);
 
 /* hotspot main interfaces - temperature.c	*/
 void steady_state_temp_block(block_model_t *model, double *power, double *temp);
+void steady_state_temp_batch_block(block_model_t *model, double **power, double **temp, int k);
 void compute_temp_block(block_model_t *model, double *power, double *temp, double time_elapsed);
 /* differs from 'dvector()' in that memory for internal nodes is also allocated	*/
 double *hotspot_vector_block(block_model_t *model);
@@ -92,6 +109,10 @@ void read_power_block (block_model_t *model, double *power, char *file);
 double find_max_temp_block(block_model_t *model, double *temp);
 double find_avg_temp_block(block_model_t *model, double *temp);
 double calc_sink_temp_block(block_model_t *model, double *temp, thermal_config_t *config); //for natural convection package model
+/* write the reduced-order model of the silicon layer to 'file'	*/
+void dump_reduced_model_block(block_model_t *model, int rank, double tol, char *file);
+/* write the eigen decomposition of the whole model to 'file'	*/
+void dump_eigendata_block(block_model_t *model, char *file);
 /* debug print	*/
 void debug_print_block(block_model_t *model);
 
@@ -2248,7 +2248,7 @@ double single_iteration_steady_pack(grid_model_t *model, grid_model_vector_t *po
 double single_iteration_steady_grid(grid_model_t *model, grid_model_vector_t *power,
                                     grid_model_vector_t *temp)
 {
-  int n, i, j;
+  int n, i, j, color, row;
   double prev, delta, max = 0;
   /* sum of the conductances	*/
   double csum;
@@ -2277,10 +2277,18 @@ double single_iteration_steady_grid(grid_model_t *model, grid_model_vector_t *po
       pcbidx = LAYER_PCB;	
   }
 
-  /* for each grid cell	*/
-  for(n=0; n < nl; n++) {
-      for(i=0; i < nr; i++) {
-          for(j=0; j < nc; j++) {
+  /* for each grid cell in red-black order. cells with an even 
+   * (layer + row + col) are updated first and the odd ones next. 
+   * neighbours in all six directions are of the other colour. so,
+   * the cells of one colour are independent of each other and 
+   * their rows can be updated in parallel
+   */
+  for(color=0; color < 2; color++) {
+#pragma omp parallel for private(n, i, j, prev, delta, csum, wsum) reduction(max:max) if (nl*nr*nc >= GRID_PARALLEL_MIN)
+      for(row=0; row < nl*nr; row++) {
+          n = row / nr;
+          i = row % nr;
+          for(j=(n+i+color) & 1; j < nc; j+=2) {
               /* sum the conductances to cells north, south, 
                * east, west, above and below
                */
@@ -2962,9 +2970,12 @@ void slope_fn_pack(grid_model_t *model, double *v, grid_model_vector_t *p, doubl
  * equation is CdV + sum{(T - Ti)/Ri} = P 
  * so, slope = dV = [P + sum{(Ti-T)/Ri}]/C
  */
-void slope_fn_grid(grid_model_t *model, double *v, grid_model_vector_t *p, double *dv)
+/* compute the slope of grid cell (n, i, j). handles the connections
+ * to the package nodes and the detailed 3D model
+ */
+void slope_cell_grid(grid_model_t *model, double *v, grid_model_vector_t *p, double *dv,
+                     int n, int i, int j)
 {
-  int n, i, j;
   /* sum of the currents(power values)	*/
   double psum;
 
@@ -2992,107 +3003,183 @@ void slope_fn_grid(grid_model_t *model, double *v, grid_model_vector_t *p, doubl
       pcbidx = LAYER_PCB;	
   }
 
-  /* for each grid cell	*/
-  for(n=0; n < nl; n++)
-    for(i=0; i < nr; i++)
-      for(j=0; j < nc; j++) {
-          /* sum the currents(power values) to cells north, south, 
-           * east, west, above and below
-           */
-          // BU_3D: uses grid specific values for all layers 
-          // spreader and heat sink layers will use uniform R
-          if(model->config.detailed_3D_used == 1){
-              psum = NP_det3D(l,v,n,i,j,nl,nr,nc) + SP_det3D(l,v,n,i,j,nl,nr,nc) + 
-                EP_det3D(l,v,n,i,j,nl,nr,nc) + WP_det3D(l,v,n,i,j,nl,nr,nc) + 
-                AP_det3D(l,v,n,i,j,nl,nr,nc) + BP_det3D(l,v,n,i,j,nl,nr,nc);
-          }
-          else{
-              psum = NP(l,v,n,i,j,nl,nr,nc) + SP(l,v,n,i,j,nl,nr,nc) + 
-                EP(l,v,n,i,j,nl,nr,nc) + WP(l,v,n,i,j,nl,nr,nc) + 
-                AP(l,v,n,i,j,nl,nr,nc) + BP(l,v,n,i,j,nl,nr,nc);
-          }//end->BU_3D
-
-          /* spreader core is connected to its periphery	*/
-          if (n == spidx) {
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SP_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SP_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SP_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SP_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
-              /* heatsink core is connected to its inner periphery and ambient	*/
-          } else if (n == hsidx) {
-              /* all nodes are connected to the ambient	*/
-              psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/l[n].rz;
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SINK_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SINK_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SINK_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SINK_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
-          }	else if (n == pcbidx && model_secondary) {
-              /* all nodes are connected to the ambient	*/
-              psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/(model->config.r_convec_sec * 
-                                                            (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[PCB_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[PCB_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[PCB_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[PCB_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
-          }	else if (n == subidx && model_secondary) {
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SUB_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SUB_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SUB_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SUB_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
-          }	else if (n == solderidx && model_secondary) {
-              /* northern boundary - edge cell has half the ry	*/
-              if (i == 0)
-                psum += (x[SOLDER_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-              /* southern boundary - edge cell has half the ry	*/
-              if (i == nr-1)
-                psum += (x[SOLDER_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
-              /* eastern boundary	 - edge cell has half the rx	*/
-              if (j == nc-1)
-                psum += (x[SOLDER_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-              /* western boundary	 - edge cell has half the rx	*/
-              if (j == 0)
-                psum += (x[SOLDER_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
-          }
+  /* sum the currents(power values) to cells north, south, 
+   * east, west, above and below
+   */
+  // BU_3D: uses grid specific values for all layers 
+  // spreader and heat sink layers will use uniform R
+  if(model->config.detailed_3D_used == 1){
+      psum = NP_det3D(l,v,n,i,j,nl,nr,nc) + SP_det3D(l,v,n,i,j,nl,nr,nc) + 
+        EP_det3D(l,v,n,i,j,nl,nr,nc) + WP_det3D(l,v,n,i,j,nl,nr,nc) + 
+        AP_det3D(l,v,n,i,j,nl,nr,nc) + BP_det3D(l,v,n,i,j,nl,nr,nc);
+  }
+  else{
+      psum = NP(l,v,n,i,j,nl,nr,nc) + SP(l,v,n,i,j,nl,nr,nc) + 
+        EP(l,v,n,i,j,nl,nr,nc) + WP(l,v,n,i,j,nl,nr,nc) + 
+        AP(l,v,n,i,j,nl,nr,nc) + BP(l,v,n,i,j,nl,nr,nc);
+  }//end->BU_3D
 
-          /* update the current cell's temperature	*/	   
-          if(model->config.detailed_3D_used == 1)//BU_3D: use find_cap_3D is detailed_3D model is used.
-            A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / find_cap_3D(n, i, j, model);
-          else
-            A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / l[n].c;
-      }
-  /* for each grid cell	*/
+  /* spreader core is connected to its periphery	*/
+  if (n == spidx) {
+      /* northern boundary - edge cell has half the ry	*/
+      if (i == 0)
+        psum += (x[SP_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+      /* southern boundary - edge cell has half the ry	*/
+      if (i == nr-1)
+        psum += (x[SP_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sp1_y); 
+      /* eastern boundary	 - edge cell has half the rx	*/
+      if (j == nc-1)
+        psum += (x[SP_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+      /* western boundary	 - edge cell has half the rx	*/
+      if (j == 0)
+        psum += (x[SP_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sp1_x); 
+      /* heatsink core is connected to its inner periphery and ambient	*/
+  } else if (n == hsidx) {
+      /* all nodes are connected to the ambient	*/
+      psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/l[n].rz;
+      /* northern boundary - edge cell has half the ry	*/
+      if (i == 0)
+        psum += (x[SINK_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+      /* southern boundary - edge cell has half the ry	*/
+      if (i == nr-1)
+        psum += (x[SINK_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_hs1_y); 
+      /* eastern boundary	 - edge cell has half the rx	*/
+      if (j == nc-1)
+        psum += (x[SINK_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+      /* western boundary	 - edge cell has half the rx	*/
+      if (j == 0)
+        psum += (x[SINK_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_hs1_x); 
+  }	else if (n == pcbidx && model_secondary) {
+      /* all nodes are connected to the ambient	*/
+      psum += (c->ambient - A3D(v,n,i,j,nl,nr,nc))/(model->config.r_convec_sec * 
+                                                    (model->config.s_pcb * model->config.s_pcb) / (cw * ch));
+      /* northern boundary - edge cell has half the ry	*/
+      if (i == 0)
+        psum += (x[PCB_C_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+      /* southern boundary - edge cell has half the ry	*/
+      if (i == nr-1)
+        psum += (x[PCB_C_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_pcb1_y); 
+      /* eastern boundary	 - edge cell has half the rx	*/
+      if (j == nc-1)
+        psum += (x[PCB_C_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
+      /* western boundary	 - edge cell has half the rx	*/
+      if (j == 0)
+        psum += (x[PCB_C_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_pcb1_x); 
+  }	else if (n == subidx && model_secondary) {
+      /* northern boundary - edge cell has half the ry	*/
+      if (i == 0)
+        psum += (x[SUB_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+      /* southern boundary - edge cell has half the ry	*/
+      if (i == nr-1)
+        psum += (x[SUB_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_sub1_y); 
+      /* eastern boundary	 - edge cell has half the rx	*/
+      if (j == nc-1)
+        psum += (x[SUB_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+      /* western boundary	 - edge cell has half the rx	*/
+      if (j == 0)
+        psum += (x[SUB_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_sub1_x); 
+  }	else if (n == solderidx && model_secondary) {
+      /* northern boundary - edge cell has half the ry	*/
+      if (i == 0)
+        psum += (x[SOLDER_N] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+      /* southern boundary - edge cell has half the ry	*/
+      if (i == nr-1)
+        psum += (x[SOLDER_S] - A3D(v,n,i,j,nl,nr,nc))/(l[n].ry/2.0 + nc*model->pack.r_solder1_y); 
+      /* eastern boundary	 - edge cell has half the rx	*/
+      if (j == nc-1)
+        psum += (x[SOLDER_E] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
+      /* western boundary	 - edge cell has half the rx	*/
+      if (j == 0)
+        psum += (x[SOLDER_W] - A3D(v,n,i,j,nl,nr,nc))/(l[n].rx/2.0 + nr*model->pack.r_solder1_x); 
+  }
+
+  /* update the current cell's temperature	*/	   
+  if(model->config.detailed_3D_used == 1)//BU_3D: use find_cap_3D is detailed_3D model is used.
+    A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / find_cap_3D(n, i, j, model);
+  else
+    A3D(dv,n,i,j,nl,nr,nc) = (p->cuboid[n][i][j] + psum) / l[n].c;
+}
+
+/* compute the slopes of row i in layer n for a layer that is only 
+ * connected to its neighbouring cells (no package nodes). each
+ * current is accumulated over the entire row at a time, so that 
+ * the loops vectorize. missing neighbours at the top and bottom 
+ * faces and the northern and southern boundaries point back to 
+ * the row itself so that they contribute no current
+ */
+void slope_row_grid(grid_model_t *model, double *v, grid_model_vector_t *p, double *dv,
+                    int n, int i)
+{
+  int j;
+
+  /* shortcuts	*/
+  layer_t *l = model->layers;
+  int nl = model->n_layers;
+  int nr = model->rows;
+  int nc = model->cols;
+
+  /* conductances to the neighbours and inverse capacitance	*/
+  double gx = 1.0/l[n].rx;
+  double gy = 1.0/l[n].ry;
+  double ga = (n > 0) ? 1.0/l[n-1].rz : 0.0;
+  double gb = 1.0/l[n].rz;
+  double invc = 1.0/l[n].c;
+
+  /* current row, its neighbours and outputs	*/
+  double *vc = &A3D(v,n,i,0,nl,nr,nc);
+  double *vn = (i > 0) ? vc - nc : vc;
+  double *vs = (i < nr-1) ? vc + nc : vc;
+  double *va = (n > 0) ? vc - nr*nc : vc;
+  double *vb = (n < nl-1) ? vc + nr*nc : vc;
+  double *pc = p->cuboid[n][i];
+  double *dvc = &A3D(dv,n,i,0,nl,nr,nc);
+
+  /* currents from north, south, above and below	*/
+  for(j=0; j < nc; j++)
+    dvc[j] = gy * (vn[j] - vc[j]) + gy * (vs[j] - vc[j]) +
+      ga * (va[j] - vc[j]) + gb * (vb[j] - vc[j]);
+  /* current from the west. zero on the western boundary	*/
+  for(j=1; j < nc; j++)
+    dvc[j] += gx * (vc[j-1] - vc[j]);
+  /* current from the east. zero on the eastern boundary	*/
+  for(j=0; j < nc-1; j++)
+    dvc[j] += gx * (vc[j+1] - vc[j]);
+  /* update the cells' temperatures	*/
+  for(j=0; j < nc; j++)
+    dvc[j] = (pc[j] + dvc[j]) * invc;
+}
+
+void slope_fn_grid(grid_model_t *model, double *v, grid_model_vector_t *p, double *dv)
+{
+  int n, i, j, row;
+  /* does the row take the vectorized path?	*/
+  int plain;
+
+  /* shortcuts	*/
+  int nl = model->n_layers;
+  int nr = model->rows;
+  int nc = model->cols;
+  int spidx, hsidx;
+  int model_secondary = model->config.model_secondary;
+
+  spidx = nl - DEFAULT_PACK_LAYERS + LAYER_SP;
+  hsidx = nl - DEFAULT_PACK_LAYERS + LAYER_SINK;
+
+  /* for each row of grid cells. the slopes only depend on 
+   * the temperatures in 'v'. so, the rows are independent
+   */
+#pragma omp parallel for private(n, i, j, plain) if (nl*nr*nc >= GRID_PARALLEL_MIN)
+  for(row=0; row < nl*nr; row++) {
+      n = row / nr;
+      i = row % nr;
+      plain = !model->config.detailed_3D_used && n != spidx && n != hsidx &&
+        !(model_secondary && (n == LAYER_SUB || n == LAYER_SOLDER || n == LAYER_PCB));
+      if (plain)
+        slope_row_grid(model, v, p, dv, n, i);
+      else
+        for(j=0; j < nc; j++)
+          slope_cell_grid(model, v, p, dv, n, i, j);
+  }
   slope_fn_pack(model, v, p, dv);
 }
 
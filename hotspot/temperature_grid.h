@@ -56,6 +56,12 @@
    Effective only when the detailed 3D modeling is turned on. */
 #define OCCUPANCY_THRESHOLD 0.95
 
+/* min. no. of grid cells (all layers) for the solver 
+ * loops to be split across threads (when built with 
+ * OPENMP=1). coarse multigrid levels stay single threaded
+ */
+#define GRID_PARALLEL_MIN	4096
+
 /* block list: block to grid mapping data structure.
  * list of blocks mapped to a grid cell	
  */
@@ -237,9 +237,19 @@ double ***dcuboid_tail(int nr, int nc, int nl, int xtra)
 	/* 2-d array of pointers denoting (layer, row)	*/
 	m[0] = (double **) calloc (nl * nr, sizeof(double *));
 	assert(m[0] != NULL);
-	/* the actual 3-d data array	*/
+	/* the actual 3-d data array. aligned to a cache line
+	 * so that the row loops of the grid solver vectorize well
+	 */
+	#ifdef _MSC_VER
 	m[0][0] = (double *) calloc (nl * nr * nc + xtra, sizeof(double));
 	assert(m[0][0] != NULL);
+	#else
+	if (posix_memalign((void **) &m[0][0], CUBOID_ALIGN, 
+					   (nl * nr * nc + xtra) * sizeof(double)))
+		m[0][0] = NULL;
+	assert(m[0][0] != NULL);
+	memset(m[0][0], 0, (nl * nr * nc + xtra) * sizeof(double));
+	#endif
 
 	/* remaining pointers of the 1-d pointer array	*/
 	for (i = 1; i < nl; i++)
@@ -23,6 +23,8 @@
 #define STR_SIZE		512
 #define LINE_SIZE		65536
 #define MAX_ENTRIES		512
+/* alignment (in bytes) of the data array of a 3-d matrix	*/
+#define CUBOID_ALIGN	64
 
 int eq(double x, double y);
 int le(double x, double y);
@@ -8,7 +8,7 @@ Works by registering a PRE_STAT_WRITE hook, which, before a stats snapshot write
 - Finally the actual snapshot is written, including updated values for all energy counters
 """
 
-import sys, os, sim
+import sys, os, copy, sim
 
 
 def build_dvfs_table(tech):
@@ -65,6 +65,16 @@ class EnergyStats:
       #sim.stats.register_per_thread('L2-'+metric, 'L2', metric)
       sim.stats.register('processor', 0, metric, self.get_stat)
       sim.stats.register('dram', 0, metric, self.get_stat)
+    # Optionally skip McPAT for periods in which every core runs a previously seen phase (see run_power)
+    self.phase_cache = sim.config.get('power/phase_cache') == 'true'
+    if self.phase_cache:
+      self.phase_threshold = float(sim.config.get('power/phase_threshold'))
+      self.phases = []        # Per-instruction BBV signature of each phase seen so far
+      self.phase_power = {}   # (phase, frequency) -> McPAT results of a core running that phase
+      self.power_last = None  # Last full McPAT results, used for the shared components
+      self.bbv_last = [ self.get_bbv(core) for core in range(sim.config.ncores) ]
+      self.phase_hits = 0
+      self.phase_misses = 0
 
   def periodic(self, time, time_delta):
     self.update()
@@ -76,6 +86,8 @@ class EnergyStats:
   def hook_sim_end(self):
     if self.name_last:
       sim.util.db_delete(self.name_last, True)
+    if self.phase_cache:
+      print '[ENERGYSTATS] %d phases, %d of %d power evaluations reused cached results' % (len(self.phases), self.phase_hits, self.phase_hits + self.phase_misses)
 
   def update(self):
     if sim.stats.time() == self.time_last_power:
@@ -143,21 +155,73 @@ vdd[] = %s
     cfg.close()
     return configfile
 
+  def get_bbv(self, core):
+    return (sim.stats.get('core', core, 'instructions'),
+            [ sim.stats.get('core', core, 'bbv-%d' % i) for i in range(16) ])
+
+  def find_phase(self, signature):
+    total = sum(signature) or 1.
+    for phase, known in enumerate(self.phases):
+      if sum([ abs(a - b) for a, b in zip(signature, known) ]) / total < self.phase_threshold:
+        return phase
+    self.phases.append(signature)
+    return len(self.phases) - 1
+
+  def classify_phases(self):
+    # Phase of each core during the last period, from its basic-block vector normalized by instruction count
+    phases = []
+    for core in range(sim.config.ncores):
+      icount, bbv = self.get_bbv(core)
+      icount_last, bbv_last = self.bbv_last[core]
+      self.bbv_last[core] = (icount, bbv)
+      if icount == icount_last:
+        phases.append('idle')
+      else:
+        phases.append(self.find_phase([ (b - l) / float(icount - icount_last) for b, l in zip(bbv, bbv_last) ]))
+    return phases
+
+  def compose_power(self, keys):
+    # Shared components keep their last McPAT results, each core gets the results cached for its phase and frequency
+    power = copy.deepcopy(self.power_last)
+    for core, key in enumerate(keys):
+      cached = self.phase_power[key]
+      power['Processor']['Runtime Dynamic'] += cached['Runtime Dynamic'] - power['Core'][core]['Runtime Dynamic']
+      power['Core'][core] = copy.deepcopy(cached)
+    return power
+
   def run_power(self, name0, name1):
     outputbase = os.path.join(sim.config.output_dir, 'energystats-temp')
 
     configfile = self.gen_config(outputbase)
 
-    os.system('unset PYTHONHOME; %s -d %s -o %s -c %s --partial=%s:%s --no-graph --no-text' % (
+    cached = False
+    if self.phase_cache:
+      keys = zip(self.classify_phases(), [ sim.dvfs.get_frequency(core) for core in range(sim.config.ncores) ])
+      if self.power_last and all([ key in self.phase_power for key in keys ]):
+        file(outputbase + '-cached.py', 'w').write('power = %r' % self.compose_power(keys))
+        cached = True
+
+    # mcpat.py still writes the power and CPI logs and runs the thermal model when using cached power
+    os.system('unset PYTHONHOME; %s -d %s -o %s -c %s --partial=%s:%s --no-graph --no-text%s' % (
       os.path.join(os.getenv('SNIPER_ROOT'), 'tools/mcpat.py'),
       sim.config.output_dir,
       outputbase,
       configfile,
-      name0, name1
+      name0, name1,
+      ' --cached-power=%s-cached.py' % outputbase if cached else ''
     ))
 
     result = {}
     execfile(outputbase + '.py', {}, result)
+
+    if self.phase_cache:
+      if cached:
+        self.phase_hits += 1
+      else:
+        self.phase_misses += 1
+        self.power_last = result['power']
+        for core, key in enumerate(keys):
+          self.phase_power[key] = result['power']['Core'][core]
     return result['power']
 
 # All scripts execute in global scope, so other scripts will be able to call energystats.update()
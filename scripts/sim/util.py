@@ -132,9 +132,13 @@ class StatsDelta:
 
 class Every:
   def __init__(self, interval, callback, statsdelta = None, roi_only = True):
-    min_interval = long(sim.config.get('clock_skew_minimization/barrier/quantum')) * 1e6
-    if interval < min_interval:
-      print >> sys.stderr, 'sim.util.Every(): interval(%dns) < periodic callback(%dns), consider reducing clock_skew_minimization/barrier/quantum' % (interval/1e6, min_interval/1e6)
+    if sim.config.get_bool('clock_skew_minimization/barrier/adaptive/enabled'):
+      # The adaptive barrier will place barriers on each multiple of interval
+      sim.control.add_periodic_interval(long(interval))
+    else:
+      min_interval = long(sim.config.get('clock_skew_minimization/barrier/quantum')) * 1e6
+      if interval < min_interval:
+        print >> sys.stderr, 'sim.util.Every(): interval(%dns) < periodic callback(%dns), consider reducing clock_skew_minimization/barrier/quantum' % (interval/1e6, min_interval/1e6)
     self.interval = interval
     self.callback = callback
     self.statsdelta = statsdelta
@@ -378,6 +378,18 @@ void openFile(THREADID threadid)
       exit(1);
    }
 
+   // Response files imply an interactive stream that cannot be replayed from the middle
+   if (KnobIndexInterval.Value() && !KnobUseResponseFiles.Value())
+   {
+      char index_filename[1024] = {0};
+      sprintf(index_filename, "%s.idx", filename);
+      if (!thread_data[threadid].output->setIndex(index_filename, KnobIndexInterval.Value()))
+      {
+         std::cerr << "[SIFT_RECORDER:" << app_id << ":" << thread_data[threadid].thread_num << "] Error: Unable to open the index file " << index_filename << std::endl;
+         exit(1);
+      }
+   }
+
    thread_data[threadid].output->setHandleAccessMemoryFunc(handleAccessMemory, reinterpret_cast<void*>(threadid));
 }
 
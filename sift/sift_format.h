@@ -18,10 +18,18 @@
 # define SIFT_USE_ZLIB 1
 #endif
 
+// The read-ahead thread (irastream) needs C++11 threads, which are not available under PinCRT
+#if defined(PIN_CRT)
+# define SIFT_USE_READAHEAD 0
+#else
+# define SIFT_USE_READAHEAD 1
+#endif
+
 namespace Sift
 {
 
    const uint32_t MagicNumber = 0x54464953; // "SIFT"
+   const uint32_t IndexMagicNumber = 0x58444953; // "SIDX"
    const uint64_t PAGE_SIZE_SIFT = 4096;
    const uint32_t ICACHE_SIZE = 0x1000;
    const uint64_t ICACHE_OFFSET_MASK = ICACHE_SIZE - 1;
@@ -115,9 +123,22 @@ namespace Sift
       RecOtherInstructionCount,
       RecOtherCacheOnly,
       RecOtherISAChange,
+      RecOtherCheckpoint,
       RecOtherEnd = 0xff,
    } RecOtherType;
 
+   // Trace index (<trace>.idx)
+   // The index file starts with a Header (magic = IndexMagicNumber), followed by Other records:
+   // copies of all state records (RecOtherIcache, RecOtherIcacheVariable, RecOtherLogical2Physical, RecOtherISAChange)
+   // in trace order, interleaved with RecOtherCheckpoint records, and terminated by RecOtherEnd.
+   // Replaying all state records up to a checkpoint restores the reader state needed to start decoding at its offset.
+   typedef struct
+   {
+      uint64_t icount;           //< Number of instructions preceding this checkpoint
+      uint64_t offset;           //< File offset of the first record after the checkpoint (raw deflate stream start when compressed)
+      uint64_t last_address;     //< Address of the next sequential instruction
+   } __attribute__ ((__packed__)) Checkpoint;
+
    typedef enum {
       EmuTypeRdtsc,
       EmuTypeGetProcInfo,
@@ -7,6 +7,8 @@
 #include <fstream>
 #include <cassert>
 #include <cstring>
+#include <string>
+#include <vector>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -43,12 +45,18 @@ Sift::Reader::Reader(const char *filename, const char *response_filename, uint32
    , handleRoutineAnnounceFunc(NULL)
    , handleRoutineArg(NULL)   
    , filesize(0)
+   , inputstream(NULL)
+   , m_readahead_size(0)
+   , m_readahead(NULL)
    , last_address(0)
    , icache()
    , m_id(id)
+   , m_icount(0)
    , m_trace_has_pa(false)
+   , m_trace_compressed(false)
    , m_seen_end(false)
    , m_last_sinst(NULL)
+   , m_skipping(false)
    , m_isa(0)
 {
 //   if (!xed_initialized)
@@ -121,6 +129,7 @@ bool Sift::Reader::initStream()
    if (hdr.options & CompressionZlib)
    {
       input = new izstream(input);
+      m_trace_compressed = true;
       hdr.options &= ~CompressionZlib;
    }
 #else
@@ -156,6 +165,8 @@ bool Sift::Reader::initStream()
       return false;
    }
 
+   initReadAhead();
+
    #if VERBOSE > 0
    std::cerr << "[DEBUG:" << m_id << "] InitStream Connection Open" << std::endl;
    #endif
@@ -163,6 +174,26 @@ bool Sift::Reader::initStream()
    return true;
 }
 
+void Sift::Reader::initReadAhead()
+{
+   if (m_readahead_size == 0)
+      return;
+
+#if SIFT_USE_READAHEAD
+   // With response files, the writer waits for us in between records so we cannot read ahead
+   if (strcmp(m_response_filename, "") != 0)
+   {
+      std::cerr << "[SIFT:" << m_id << "] Warning: Read-ahead is not supported with response files, ignoring\n";
+      return;
+   }
+
+   m_readahead = new irastream(input, m_readahead_size, inputstream);
+   input = m_readahead;
+#else
+   std::cerr << "[SIFT:" << m_id << "] Warning: Read-ahead disabled at compile time, ignoring\n";
+#endif
+}
+
 bool Sift::Reader::initResponse()
 {
    if (!response)
@@ -218,53 +249,11 @@ bool Sift::Reader::Read(Instruction &inst)
                //sendSimpleResponse(RecOtherEndResponse);
                return false;
             case RecOtherIcache:
-            {
-               assert(rec.Other.size == sizeof(uint64_t) + ICACHE_SIZE);
-               uint64_t address;
-               uint8_t *bytes = new uint8_t[ICACHE_SIZE];
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(bytes), ICACHE_SIZE);
-               icache[address] = bytes;
-               break;
-            }
             case RecOtherIcacheVariable:
-            {
-               #if VERBOSE_ICACHE
-               std::cerr << __FUNCTION__ << ": rec=" << std::endl;
-               hexdump(&rec, sizeof(rec.Other));
-               #endif
-               uint64_t address;
-               size_t size = rec.Other.size - sizeof(uint64_t);
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               size_t size_left = size;
-               while (size_left > 0)
-               {
-                  uint64_t base_addr = address & ICACHE_PAGE_MASK;
-                  if (icache.count(base_addr) == 0)
-                     icache[base_addr] = new uint8_t[ICACHE_SIZE];
-                  uint64_t offset = address & ICACHE_OFFSET_MASK;
-                  size_t read_amount = std::min(size_left, size_t(ICACHE_SIZE - offset));
-                  input->read(const_cast<char*>(reinterpret_cast<const char*>(&(icache[base_addr][offset]))), read_amount);
-
-                  #if VERBOSE_ICACHE
-                  std::cerr << __FUNCTION__ << ": Wrote " << read_amount << " bytes to 0x" << std::hex << (void*)&(icache[base_addr][offset]) << std::dec << std::endl;
-                  hexdump(&(icache[base_addr][offset]), read_amount);
-                  #endif
-
-                  size_left -= read_amount;
-                  address = base_addr + ICACHE_SIZE;
-               }
-               break;
-            }
             case RecOtherLogical2Physical:
-            {
-               assert(rec.Other.size == 2 * sizeof(uint64_t));
-               uint64_t vp, pp;
-               input->read(reinterpret_cast<char*>(&vp), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&pp), sizeof(uint64_t));
-               vcache[vp] = pp;
+            case RecOtherISAChange:
+               handleStateRecord(input, rec);
                break;
-            }
             case RecOtherInstructionCount:
             {
                #if VERBOSE > 0
@@ -274,7 +263,7 @@ bool Sift::Reader::Read(Instruction &inst)
                uint32_t icount;
                input->read(reinterpret_cast<char*>(&icount), sizeof(icount));
                Mode mode = ModeUnknown;
-               if (handleInstructionCountFunc)
+               if (handleInstructionCountFunc && !m_skipping)
                   mode = handleInstructionCountFunc(handleInstructionCountArg, icount);
                sendSimpleResponse(RecOtherSyncResponse, &mode, sizeof(Mode));
                break;
@@ -291,7 +280,7 @@ bool Sift::Reader::Read(Instruction &inst)
                input->read(reinterpret_cast<char*>(&type), sizeof(uint8_t));
                input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
                input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               if (handleCacheOnlyFunc)
+               if (handleCacheOnlyFunc && !m_skipping)
                   handleCacheOnlyFunc(handleCacheOnlyArg, icount, (Sift::CacheOnlyType)type, eip, address);
                break;
             }
@@ -386,7 +375,7 @@ bool Sift::Reader::Read(Instruction &inst)
             {
                assert(rec.Other.size == 0);
                Mode mode = ModeUnknown;
-               if (handleInstructionCountFunc)
+               if (handleInstructionCountFunc && !m_skipping)
                   mode = handleInstructionCountFunc(handleInstructionCountArg, 0);
                sendSimpleResponse(RecOtherSyncResponse, &mode, sizeof(Mode));
                break;
@@ -416,7 +405,7 @@ bool Sift::Reader::Read(Instruction &inst)
                input->read(reinterpret_cast<char*>(&b), sizeof(uint64_t));
                input->read(reinterpret_cast<char*>(&c), sizeof(uint64_t));
                uint64_t result;
-               if (handleMagicFunc)
+               if (handleMagicFunc && !m_skipping)
                {
                   result = handleMagicFunc(handleMagicArg, a, b, c);
                }
@@ -450,7 +439,7 @@ bool Sift::Reader::Read(Instruction &inst)
                input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
                input->read(reinterpret_cast<char*>(&esp), sizeof(uint64_t));
                input->read(reinterpret_cast<char*>(&callEip), sizeof(uint64_t));
-               if (handleRoutineChangeFunc)
+               if (handleRoutineChangeFunc && !m_skipping)
                   handleRoutineChangeFunc(handleRoutineArg, Sift::RoutineOpType(event), eip, esp, callEip);
                break;
             }
@@ -479,15 +468,6 @@ bool Sift::Reader::Read(Instruction &inst)
                free(filename);
                break;
             }            
-            case RecOtherISAChange:
-            { 
-               assert(rec.Other.size == sizeof(uint32_t));
-               uint32_t new_isa;
-               input->read(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
-               m_isa = new_isa; // save here new ISA mode value
-
-               break;
-            }
             default:
             {
                uint8_t *bytes = new uint8_t[rec.Other.size];
@@ -551,6 +531,8 @@ bool Sift::Reader::Read(Instruction &inst)
       #if VERBOSE_HEX > 2
       hexdump(inst.sinst->data, inst.sinst->size);
       #endif
+      m_icount++;
+
       #if VERBOSE > 2
       printf("%016lx (%d) A%u %c%c %c%c\n", inst.sinst->addr, inst.sinst->size, inst.num_addresses, inst.is_branch?'B':'.', inst.is_branch?(inst.taken?'T':'.'):'.', inst.is_predicate?'C':'.', inst.is_predicate?(inst.executed?'E':'n'):'.');
       #endif
@@ -563,6 +545,204 @@ bool Sift::Reader::Read(Instruction &inst)
    return true;
 }
 
+void Sift::Reader::handleStateRecord(vistream *stream, const Record &rec)
+{
+   // Records that update reader state needed to decode later instructions.
+   // These are read either from the trace itself, or from the trace index when seeking.
+   switch(rec.Other.type)
+   {
+      case RecOtherIcache:
+      {
+         assert(rec.Other.size == sizeof(uint64_t) + ICACHE_SIZE);
+         uint64_t address;
+         stream->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+         // After a Seek, pages restored from the index are sent again by the trace
+         if (icache.count(address) == 0)
+            icache[address] = new uint8_t[ICACHE_SIZE];
+         stream->read(const_cast<char*>(reinterpret_cast<const char*>(icache[address])), ICACHE_SIZE);
+         break;
+      }
+      case RecOtherIcacheVariable:
+      {
+         #if VERBOSE_ICACHE
+         std::cerr << __FUNCTION__ << ": rec=" << std::endl;
+         hexdump(&rec, sizeof(rec.Other));
+         #endif
+         uint64_t address;
+         size_t size = rec.Other.size - sizeof(uint64_t);
+         stream->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+         size_t size_left = size;
+         while (size_left > 0)
+         {
+            uint64_t base_addr = address & ICACHE_PAGE_MASK;
+            if (icache.count(base_addr) == 0)
+               icache[base_addr] = new uint8_t[ICACHE_SIZE];
+            uint64_t offset = address & ICACHE_OFFSET_MASK;
+            size_t read_amount = std::min(size_left, size_t(ICACHE_SIZE - offset));
+            stream->read(const_cast<char*>(reinterpret_cast<const char*>(&(icache[base_addr][offset]))), read_amount);
+
+            #if VERBOSE_ICACHE
+            std::cerr << __FUNCTION__ << ": Wrote " << read_amount << " bytes to 0x" << std::hex << (void*)&(icache[base_addr][offset]) << std::dec << std::endl;
+            hexdump(&(icache[base_addr][offset]), read_amount);
+            #endif
+
+            size_left -= read_amount;
+            address = base_addr + ICACHE_SIZE;
+         }
+         break;
+      }
+      case RecOtherLogical2Physical:
+      {
+         assert(rec.Other.size == 2 * sizeof(uint64_t));
+         uint64_t vp, pp;
+         stream->read(reinterpret_cast<char*>(&vp), sizeof(uint64_t));
+         stream->read(reinterpret_cast<char*>(&pp), sizeof(uint64_t));
+         vcache[vp] = pp;
+         break;
+      }
+      case RecOtherISAChange:
+      {
+         assert(rec.Other.size == sizeof(uint32_t));
+         uint32_t new_isa;
+         stream->read(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
+         m_isa = new_isa; // save here new ISA mode value
+         break;
+      }
+      default:
+         assert(false);
+   }
+}
+
+static bool readIndexHeader(vistream &index)
+{
+   Sift::Header hdr;
+   index.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+   return !index.fail() && hdr.magic == Sift::IndexMagicNumber;
+}
+
+bool Sift::Reader::Seek(uint64_t icount)
+{
+   if (input == NULL)
+   {
+      if (!initStream())
+      {
+         std::cerr << "[SIFT:" << m_id << "] Error: initStream failed\n";
+         return false;
+      }
+   }
+
+   // Find the last checkpoint at or before icount. Of the state records in the index, only those preceding it
+   // describe the trace up to its offset: the ones after it are read again from the trace once we get there.
+   std::string index_filename = std::string(m_filename) + ".idx";
+   vifstream index(index_filename.c_str(), std::ios::in | std::ios::binary);
+   if (!readIndexHeader(index))
+   {
+      std::cerr << "[SIFT:" << m_id << "] Cannot open index " << index_filename << "\n";
+      return false;
+   }
+
+   Checkpoint cp = { 0, 0, 0 };
+   bool found = false;
+   uint64_t num_state_records = 0, cp_state_records = 0;
+   std::vector<char> payload;
+   while(true)
+   {
+      Record rec;
+      index.read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+      if (index.fail() || rec.Other.type == RecOtherEnd)
+         break;
+
+      if (rec.Other.type == RecOtherCheckpoint)
+      {
+         assert(rec.Other.size == sizeof(Checkpoint));
+         Checkpoint next;
+         index.read(reinterpret_cast<char*>(&next), sizeof(Checkpoint));
+         if (next.icount > icount)
+            break;
+         cp = next;
+         cp_state_records = num_state_records;
+         found = true;
+      }
+      else
+      {
+         payload.resize(rec.Other.size);
+         index.read(payload.data(), rec.Other.size);
+         ++num_state_records;
+      }
+   }
+
+   if (!found)
+   {
+      std::cerr << "[SIFT:" << m_id << "] No checkpoint found before instruction " << icount << "\n";
+      return false;
+   }
+
+   // Only jump if the checkpoint is ahead of where we are, else just skip forward with the current state
+   if (cp.icount > m_icount || icount < m_icount)
+   {
+      #if VERBOSE > 0
+      std::cerr << "[DEBUG:" << m_id << "] Seek to checkpoint icount=" << cp.icount << " offset=" << cp.offset << std::endl;
+      #endif
+
+      // Restore the state records that precede the checkpoint
+      vifstream state(index_filename.c_str(), std::ios::in | std::ios::binary);
+      readIndexHeader(state);
+      for(uint64_t n = 0; n < cp_state_records; )
+      {
+         Record rec;
+         state.read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+         assert(!state.fail());
+         if (rec.Other.type == RecOtherCheckpoint)
+         {
+            payload.resize(rec.Other.size);
+            state.read(payload.data(), rec.Other.size);
+         }
+         else
+         {
+            handleStateRecord(&state, rec);
+            ++n;
+         }
+      }
+
+      // Drop the current stream and reopen it at the checkpoint offset
+      delete input;
+      m_readahead = NULL;
+      inputstream = new std::ifstream(m_filename, std::ios::in);
+      inputstream->seekg(cp.offset);
+      input = new vifstream(inputstream);
+#if SIFT_USE_ZLIB
+      if (m_trace_compressed)
+         input = new izstream(input, true /* raw */);
+#endif
+      initReadAhead();
+      if (input->fail())
+      {
+         std::cerr << "[SIFT:" << m_id << "] Cannot seek to offset " << cp.offset << "\n";
+         return false;
+      }
+
+      last_address = cp.last_address;
+      m_last_sinst = NULL;
+      m_seen_end = false;
+      m_icount = cp.icount;
+   }
+
+   // The skipped instructions were not executed in this run, so keep them from the callbacks
+   Instruction inst;
+   m_skipping = true;
+   while(m_icount < icount)
+   {
+      if (!Read(inst))
+      {
+         m_skipping = false;
+         return false;
+      }
+   }
+   m_skipping = false;
+
+   return true;
+}
+
 bool Sift::Reader::AccessMemory(MemoryLockType lock_signal, MemoryOpType mem_op, uint64_t d_addr, uint8_t *data_buffer, uint32_t data_size)
 {
    #if VERBOSE > 0
@@ -791,7 +971,10 @@ void Sift::Reader::sendSimpleResponse(RecOtherType type, void *data, uint32_t si
 
 uint64_t Sift::Reader::getPosition()
 {
-   if (inputstream)
+   // The helper thread owns the file stream, ask it for its position
+   if (m_readahead)
+      return m_readahead->getPosition();
+   else if (inputstream)
       return inputstream->tellg();
    else
       return 0;
@@ -14,6 +14,7 @@
 
 class vistream;
 class vostream;
+class irastream;
 
 namespace Sift
 {
@@ -83,6 +84,8 @@ namespace Sift
          void *handleRoutineArg;
          uint64_t filesize;
          std::ifstream *inputstream;
+         size_t m_readahead_size;
+         irastream *m_readahead;
 
          char *m_filename;
          char *m_response_filename;
@@ -96,14 +99,19 @@ namespace Sift
          std::unordered_map<uint64_t, uint64_t> vcache;
 
          uint32_t m_id;
+         uint64_t m_icount;
 
          bool m_trace_has_pa;
+         bool m_trace_compressed;
          bool m_seen_end;
          const StaticInstruction *m_last_sinst;
+         bool m_skipping; // Skipping instructions in Seek, don't report them through the callbacks
          
          int m_isa;
 
          bool initResponse();
+         void initReadAhead();
+         void handleStateRecord(vistream *stream, const Record &rec);
          const Sift::StaticInstruction* staticInfoInstruction(uint64_t addr, uint8_t size);
          const Sift::StaticInstruction* getStaticInstruction(uint64_t addr, uint8_t size);
          void sendSyscallResponse(uint64_t return_code);
@@ -115,8 +123,13 @@ namespace Sift
          ~Reader();
          bool initStream();
          bool Read(Instruction&);
+         // Position the trace such that the next Read returns instruction <icount>, using the trace index (<filename>.idx)
+         bool Seek(uint64_t icount);
          bool AccessMemory(MemoryLockType lock_signal, MemoryOpType mem_op, uint64_t d_addr, uint8_t *data_buffer, uint32_t data_size);
 
+         // Parse the trace from a buffer of <size> bytes filled by a helper thread, call before initStream
+         void setReadAhead(size_t size) { m_readahead_size = size; }
+
          void setHandleInstructionCountFunc(HandleInstructionCountFunc func, void* arg = NULL) { handleInstructionCountFunc = func; handleInstructionCountArg = arg; }
          void setHandleCacheOnlyFunc(HandleCacheOnlyFunc func, void* arg = NULL) { handleCacheOnlyFunc = func; handleCacheOnlyArg = arg; }
          void setHandleOutputFunc(HandleOutputFunc func, void* arg = NULL) { handleOutputFunc = func; handleOutputArg = arg; }
@@ -130,6 +143,7 @@ namespace Sift
 
          uint64_t getPosition();
          uint64_t getLength();
+         uint64_t getInstructionCount() const { return m_icount; }
          bool getTraceHasPhysicalAddresses() const { return m_trace_has_pa; }
          uint64_t va2pa(uint64_t va);
    };
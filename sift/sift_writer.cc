@@ -36,7 +36,8 @@ __sift_assert_fail(__const char *__assertion, __const char *__file,
 
 
 Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression, const char *response_filename, uint32_t id, bool arch32, bool requires_icache_per_insn, bool send_va2pa_mapping, GetCodeFunc2 getCodeFunc2, void* getCodeFunc2Data)
-   : response(NULL)
+   : index(NULL)
+   , response(NULL)
    , getCodeFunc(getCodeFunc)
    , getCodeFunc2(getCodeFunc2)
    , getCodeFunc2Data(getCodeFunc2Data)
@@ -46,6 +47,8 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    , ninstrsmall(0)
    , ninstrext(0)
    , last_address(0)
+   , index_interval(0)
+   , index_next(0)
    , icache()
    , fd_va(-1)
    , m_va2pa()
@@ -102,6 +105,61 @@ String get_working_path()
    return ( getcwd(temp, MAXPATHLEN) ? String( temp ) : String("") );
 }
 
+bool Sift::Writer::setIndex(const char *index_filename, uint64_t interval)
+{
+   sift_assert(ninstrs == 0);
+   sift_assert(interval > 0);
+
+   if (!output)
+   {
+      return false;
+   }
+
+   index = new vofstream(index_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+   if (!index->is_open())
+   {
+      std::cerr << "[SIFT:" << m_id << "] Cannot open " << index_filename << "\n";
+      delete index;
+      index = NULL;
+      return false;
+   }
+
+   Sift::Header hdr = { Sift::IndexMagicNumber, 0 /* header size */, 0 /* options */, {}};
+   index->write(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+
+   index_interval = interval;
+   index_next = 0;
+
+   return true;
+}
+
+void Sift::Writer::writeState(const void *data, std::streamsize size)
+{
+   // State records are needed to decode any later part of the trace, keep a copy in the index
+   output->write(reinterpret_cast<const char*>(data), size);
+   if (index)
+      index->write(reinterpret_cast<const char*>(data), size);
+}
+
+void Sift::Writer::writeCheckpoint()
+{
+   #if VERBOSE > 1
+   std::cerr << "[DEBUG:" << m_id << "] Write Checkpoint icount=" << ninstrs << std::endl;
+   #endif
+
+   Checkpoint cp;
+   cp.icount = ninstrs;
+   cp.offset = output->checkpoint();
+   cp.last_address = last_address;
+
+   Record rec;
+   rec.Other.zero = 0;
+   rec.Other.type = RecOtherCheckpoint;
+   rec.Other.size = sizeof(Checkpoint);
+   index->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+   index->write(reinterpret_cast<char*>(&cp), sizeof(Checkpoint));
+}
+
 void Sift::Writer::initResponse()
 {
    if (!response)
@@ -128,6 +186,17 @@ void Sift::Writer::End()
       output->flush();
    }
 
+   if (index)
+   {
+      Record rec;
+      rec.Other.zero = 0;
+      rec.Other.type = RecOtherEnd;
+      rec.Other.size = 0;
+      index->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+      delete index;
+      index = NULL;
+   }
+
    if (response)
    {
 /*
@@ -180,6 +249,12 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
       return;
    }
 
+   if (index && ninstrs == index_next)
+   {
+      writeCheckpoint();
+      index_next += index_interval;
+   }
+
    if (m_requires_icache_per_insn)
    {
       if (! icache[addr])
@@ -191,8 +266,8 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
          rec.Other.zero = 0;
          rec.Other.type = RecOtherIcacheVariable;
          rec.Other.size = sizeof(uint64_t) + size;
-         output->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
-         output->write(reinterpret_cast<char*>(&addr), sizeof(uint64_t));
+         writeState(&rec, sizeof(rec.Other));
+         writeState(&addr, sizeof(uint64_t));
 
          uint8_t buffer[16] = {0};
          if (getCodeFunc2) {
@@ -200,7 +275,7 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
          } else {
             getCodeFunc(buffer, reinterpret_cast<const uint8_t *>(addr), size);
          }
-         output->write(reinterpret_cast<char*>(buffer), size);
+         writeState(buffer, size);
 
          #if VERBOSE_ICACHE
          hexdump((char*)buffer, sizeof(buffer));
@@ -223,8 +298,8 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
             rec.Other.zero = 0;
             rec.Other.type = RecOtherIcache;
             rec.Other.size = sizeof(uint64_t) + ICACHE_SIZE;
-            output->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
-            output->write(reinterpret_cast<char*>(&base_addr), sizeof(uint64_t));
+            writeState(&rec, sizeof(rec.Other));
+            writeState(&base_addr, sizeof(uint64_t));
 
             uint8_t buffer[ICACHE_SIZE];
             if (getCodeFunc2) {
@@ -232,7 +307,7 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
             } else {
                getCodeFunc(buffer, (const uint8_t *)base_addr, ICACHE_SIZE);
             }
-            output->write(reinterpret_cast<char*>(buffer), ICACHE_SIZE);
+            writeState(buffer, ICACHE_SIZE);
 
             icache[base_addr] = true;
          }
@@ -887,8 +962,8 @@ void Sift::Writer::ISAChange(uint32_t new_isa)
    hexdump((char*)&new_isa, sizeof(new_isa));
    #endif
 
-   output->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
-   output->write(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
+   writeState(&rec, sizeof(rec.Other));
+   writeState(&new_isa, sizeof(new_isa));
 }
 
 bool Sift::Writer::IsOpen()
@@ -1069,9 +1144,9 @@ void Sift::Writer::send_va2pa(uint64_t va)
             rec.Other.zero = 0;
             rec.Other.type = RecOtherLogical2Physical;
             rec.Other.size = 2 * sizeof(uint64_t);
-            output->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
-            output->write(reinterpret_cast<char*>(&vp), sizeof(uint64_t));
-            output->write(reinterpret_cast<char*>(&pp), sizeof(uint64_t));
+            writeState(&rec, sizeof(rec.Other));
+            writeState(&vp, sizeof(uint64_t));
+            writeState(&pp, sizeof(uint64_t));
 
             m_va2pa[vp] = true;
          }
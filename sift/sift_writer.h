@@ -21,6 +21,7 @@ namespace Sift
 
       private:
          vostream *output;
+         vostream *index;
          vistream *response;
          GetCodeFunc getCodeFunc;
          GetCodeFunc2 getCodeFunc2;
@@ -30,6 +31,7 @@ namespace Sift
          uint64_t ninstrs, hsize[16], haddr[MAX_DYNAMIC_ADDRESSES+1], nbranch, npredicate, ninstrsmall, ninstrext;
 
          uint64_t last_address;
+         uint64_t index_interval, index_next;
          std::unordered_map<uint64_t, bool> icache;
          int fd_va;
          std::unordered_map<intptr_t, bool> m_va2pa;
@@ -41,6 +43,8 @@ namespace Sift
          void initResponse();
          void handleMemoryRequest(Record &respRec);
          void send_va2pa(uint64_t va);
+         void writeState(const void *data, std::streamsize size);
+         void writeCheckpoint();
          uint64_t va2pa_lookup(uint64_t va);
 
       public:
@@ -63,6 +67,8 @@ namespace Sift
          void ISAChange(uint32_t new_isa);
          bool IsOpen();
 
+         // Write an index with a checkpoint every <interval> instructions, allowing Reader::Seek
+         bool setIndex(const char *index_filename, uint64_t interval);
          void setHandleAccessMemoryFunc(HandleAccessMemoryFunc func, void* arg = NULL) { assert(func); handleAccessMemoryFunc = func; handleAccessMemoryArg = arg; }
    };
 };
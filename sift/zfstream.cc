@@ -22,11 +22,17 @@ void ozstream::doCompress(bool finish)
 {
 }
 
-izstream::izstream(vistream *input)
+uint64_t ozstream::checkpoint()
+{
+   return 0;
+}
+
+izstream::izstream(vistream *input, bool raw)
    : input(input)
    , m_eof(false)
    , m_fail(false)
    , peek_valid(false)
+   , m_gcount(0)
 {
 }
 
@@ -89,20 +95,39 @@ void ozstream::doCompress(bool finish)
       assert(ret == Z_STREAM_END);
 }
 
+uint64_t ozstream::checkpoint()
+{
+   /* Full flush: byte-align the output and reset the dictionary so that a raw inflate can start here */
+
+   zstream.next_in = Z_NULL;
+   zstream.avail_in = 0;
+   do
+   {
+      zstream.next_out = (Bytef*)buffer;
+      zstream.avail_out = chunksize;
+      int ret = deflate(&zstream, Z_FULL_FLUSH);
+      assert(ret != Z_STREAM_ERROR);
+      output->write(buffer, chunksize - zstream.avail_out);
+   } while(zstream.avail_out == 0);
+   return output->checkpoint();
+}
+
 
 
-izstream::izstream(vistream *input)
+izstream::izstream(vistream *input, bool raw)
    : input(input)
    , m_eof(false)
    , m_fail(false)
    , peek_valid(false)
+   , m_gcount(0)
 {
    zstream.zalloc = Z_NULL;
    zstream.zfree = Z_NULL;
    zstream.opaque = Z_NULL;
    zstream.avail_in = 0;
    zstream.next_in = Z_NULL;
-   int ret = inflateInit(&zstream);
+   // Raw mode (no zlib header) is used to resume decoding at a full-flush point, see ozstream::checkpoint()
+   int ret = raw ? inflateInit2(&zstream, -MAX_WBITS) : inflateInit(&zstream);
    assert(ret == Z_OK);
 }
 
@@ -114,18 +139,21 @@ izstream::~izstream()
 
 void izstream::read(char* s, std::streamsize n)
 {
+   m_gcount = 0;
    if (peek_valid)
    {
       s[0] = peek_value;
       peek_valid = false;
       ++s;
       --n;
+      m_gcount = 1;
    }
    if (n == 0)
       return;
 
    zstream.next_out = (Bytef*)s;
    zstream.avail_out = n;
+   m_gcount += n;
 
    do
    {
@@ -140,6 +168,7 @@ void izstream::read(char* s, std::streamsize n)
          m_eof = true;
          if (zstream.avail_out)
          {
+            m_gcount -= zstream.avail_out;
             m_fail = true;
             return;
          }
@@ -160,3 +189,179 @@ int izstream::peek()
 }
 
 #endif /*SIFT_USE_ZLIB*/
+
+
+#if !SIFT_USE_READAHEAD
+
+irastream::irastream(vistream *input, size_t size, std::ifstream *file)
+   : input(input)
+   , file(file)
+   , buffer(NULL)
+   , m_size(0)
+   , m_mask(0)
+   , m_fail(false)
+   , m_gcount(0)
+{
+   assert(false);
+}
+
+irastream::~irastream()
+{
+}
+
+void irastream::read(char* s, std::streamsize n)
+{
+}
+
+int irastream::peek()
+{
+   return 0;
+}
+
+uint64_t irastream::getPosition() const
+{
+   return 0;
+}
+
+#else /*SIFT_USE_READAHEAD*/
+
+#include <cstring>
+
+irastream::irastream(vistream *input, size_t size, std::ifstream *file)
+   : input(input)
+   , file(file)
+   , m_fail(false)
+   , m_gcount(0)
+   , m_head(0)
+   , m_tail(0)
+   , m_position(0)
+   , m_eof(false)
+   , m_stop(false)
+   , m_waiting(false)
+{
+   // Round up to a power of two, and make sure the helper thread can always do a full-size read
+   m_size = chunksize;
+   while (m_size < size || m_size < 2 * chunksize)
+      m_size <<= 1;
+   m_mask = m_size - 1;
+   buffer = new char[m_size];
+
+   m_thread = std::thread(&irastream::run, this);
+}
+
+irastream::~irastream()
+{
+   m_stop = true;
+   wakeup();
+   m_thread.join();
+   delete [] buffer;
+   delete input;
+}
+
+void irastream::run()
+{
+   char data[chunksize];
+
+   while (!m_stop)
+   {
+      // Wait for room for a full chunk
+      if (m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_acquire) > m_size - chunksize)
+      {
+         wait(true);
+         continue;
+      }
+
+      input->read(data, chunksize);
+      std::streamsize n = input->gcount();
+
+      uint64_t head = m_head.load(std::memory_order_relaxed);
+      size_t offset = head & m_mask;
+      size_t first = std::min(size_t(n), m_size - offset);
+      memcpy(buffer + offset, data, first);
+      memcpy(buffer, data + first, n - first);
+      if (file && file->tellg() >= 0)
+         m_position.store(file->tellg(), std::memory_order_relaxed);
+      m_head.store(head + n);
+
+      if (input->fail())
+         m_eof = true;
+      wakeup();
+      if (m_eof)
+         break;
+   }
+}
+
+void irastream::wait(bool producer)
+{
+   std::unique_lock<std::mutex> l(m_lock);
+   m_waiting = true;
+   // Re-check the condition after announcing ourselves, the other side may have made progress in the mean time
+   if (m_stop)
+      return;
+   uint64_t used = m_head.load() - m_tail.load();
+   if (producer ? (used > m_size - chunksize) : (used == 0 && !m_eof))
+      m_cond.wait(l);
+}
+
+void irastream::wakeup()
+{
+   if (m_waiting)
+   {
+      std::lock_guard<std::mutex> l(m_lock);
+      m_waiting = false;
+      m_cond.notify_all();
+   }
+}
+
+bool irastream::fill(std::streamsize n)
+{
+   // Wait until at least n bytes are available, or the input has run dry
+   while (true)
+   {
+      bool eof = m_eof;
+      if (m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed) >= uint64_t(n))
+         return true;
+      if (eof)
+         return false;
+      wait(false);
+   }
+}
+
+void irastream::read(char* s, std::streamsize n)
+{
+   m_gcount = 0;
+   while (n > 0)
+   {
+      if (!fill(1))
+      {
+         m_fail = true;
+         return;
+      }
+      uint64_t tail = m_tail.load(std::memory_order_relaxed);
+      size_t offset = tail & m_mask;
+      size_t amount = std::min(size_t(m_head.load(std::memory_order_acquire) - tail), std::min(size_t(n), m_size - offset));
+      memcpy(s, buffer + offset, amount);
+      m_tail.store(tail + amount);
+      wakeup();
+      s += amount;
+      n -= amount;
+      m_gcount += amount;
+   }
+}
+
+int irastream::peek()
+{
+   if (!fill(1))
+   {
+      m_fail = true;
+      return EOF;
+   }
+   return (unsigned char)buffer[m_tail.load(std::memory_order_relaxed) & m_mask];
+}
+
+uint64_t irastream::getPosition() const
+{
+   return m_position.load(std::memory_order_relaxed);
+}
+
+#endif /*SIFT_USE_READAHEAD*/
@@ -10,6 +10,12 @@
 #if SIFT_USE_ZLIB
 # include <zlib.h>
 #endif
+#if SIFT_USE_READAHEAD
+# include <atomic>
+# include <condition_variable>
+# include <mutex>
+# include <thread>
+#endif
 
 class vostream
 {
@@ -19,6 +25,8 @@ class vostream
       virtual void flush() = 0;
       virtual bool is_open() = 0;
       virtual bool fail() = 0;
+      // Make all data written so far decodable on its own, return the file offset at which decoding can resume
+      virtual uint64_t checkpoint() = 0;
 };
 
 class vofstream : public vostream
@@ -39,6 +47,8 @@ class vofstream : public vostream
          { return stream->fail(); }
       virtual bool is_open()
          { return stream->is_open(); }
+      virtual uint64_t checkpoint()
+         { return stream->tellp(); }
 };
 
 class ozstream : public vostream
@@ -62,6 +72,7 @@ class ozstream : public vostream
          { return output->fail(); }
       virtual bool is_open()
          { return output->is_open(); }
+      virtual uint64_t checkpoint();
 };
 
 
@@ -73,6 +84,7 @@ class vistream
       virtual void read(char* s, std::streamsize n) = 0;
       virtual int peek() = 0;
       virtual bool fail() const = 0;
+      virtual std::streamsize gcount() const = 0;
 };
 
 class vifstream : public vistream
@@ -90,6 +102,7 @@ class vifstream : public vistream
       virtual int peek()
          { return stream->peek(); }
       virtual bool fail() const { return stream->fail(); }
+      virtual std::streamsize gcount() const { return stream->gcount(); }
 };
 
 class izstream : public vistream
@@ -105,13 +118,54 @@ class izstream : public vistream
       char buffer[chunksize];
       char peek_value;
       bool peek_valid;
+      std::streamsize m_gcount;
    public:
-      izstream(vistream *input);
+      izstream(vistream *input, bool raw = false);
       virtual ~izstream();
       virtual void read(char* s, std::streamsize n);
       virtual int peek();
       virtual bool eof() const { return m_eof; }
       virtual bool fail() const { return m_fail; }
+      virtual std::streamsize gcount() const { return m_gcount; }
+};
+
+// Read-ahead stream: a helper thread reads (and decompresses) the input into a ring buffer,
+// the consumer only copies out data that is already available.
+// Only usable for non-interactive inputs, as the helper thread will read ahead past any request-response exchange.
+class irastream : public vistream
+{
+   private:
+      vistream *input;
+      std::ifstream *file;       //< Underlying file, for reporting progress (optional)
+      static const size_t chunksize = 16*1024;
+      char *buffer;
+      size_t m_size, m_mask;
+      bool m_fail;
+      std::streamsize m_gcount;
+#if SIFT_USE_READAHEAD
+      std::atomic<uint64_t> m_head;          //< Bytes produced, written by helper thread
+      std::atomic<uint64_t> m_tail;          //< Bytes consumed, written by consumer
+      std::atomic<uint64_t> m_position;      //< File position after the last read by the helper thread
+      std::atomic<bool> m_eof;
+      std::atomic<bool> m_stop;
+      std::atomic<bool> m_waiting;           //< Either side is (about to be) sleeping on m_cond
+      std::mutex m_lock;
+      std::condition_variable m_cond;
+      std::thread m_thread;
+
+      void run();
+      void wait(bool producer);
+      void wakeup();
+#endif
+      bool fill(std::streamsize n);
+   public:
+      irastream(vistream *input, size_t size, std::ifstream *file = NULL);
+      virtual ~irastream();
+      virtual void read(char* s, std::streamsize n);
+      virtual int peek();
+      virtual bool fail() const { return m_fail; }
+      virtual std::streamsize gcount() const { return m_gcount; }
+      uint64_t getPosition() const;
 };
 
 #endif // __ZFSTREAM_H
@@ -14,6 +14,11 @@ DRAM_POWER_READ = .388 + .271 + .019 # act + rd + dq
 DRAM_POWER_WRITE = .388 + .238 + .019 + .180 # act + wr + dq + termW
 DRAM_CLOCK = 266 # MHz
 
+# McPAT evaluates leakage at this temperature (Kelvin)
+MCPAT_TEMPERATURE = 330
+# Leakage curves are fitted from a second McPAT run at this much higher temperature
+LEAKAGE_FIT_DELTA = 30
+
 # interface power
 DRAM_POWER_STATIC_OFFCHIP_INTERFACE = .175/8 # 175mW for the DIMM, assuming 8 chips/DIMM as below
 DRAM_POWER_STATIC_TSV_INTERFACE = .00934/8 # 9.34mW for 64-bit data bus
@@ -219,34 +224,36 @@ def log_cpi_stack(results):
           f.write('-')
         f.write('\n')
 
-def main(jobid, resultsdir, outputfile, powertype = 'dynamic', config = None, no_graph = False, partial = None, print_stack = True, return_data = False):
-  tempfile = outputfile + '.xml'
-
-  results = sniper_lib.get_results(jobid, resultsdir, partial = partial)
-  if config:
-    # update using energystats-temp.cfg
-    results['config'] = sniper_config.parse_config(file(config).read(), results['config'])
-
-    # recompute cycle counts with updated frequencies
-    _results = sniper_lib.parse_results_from_dir(resultsdir, partial=partial, metrics=None)
-    results['results'] = sniper_lib.stats_process(results['config'], _results)
-
+def mcpat_power(jobid, resultsdir, results, tempfile, outputfile, partial):
   stats = sniper_stats.SniperStats(resultsdir = resultsdir, jobid = jobid)
 
   power, nuca_at_level = edit_XML(stats, results['results'], results['config'])
   power = map(lambda v: v[0], power)
   file(tempfile, "w").write('\n'.join(power))
 
-  # Log Performance Counters
-  log_frequencies(results)
-  log_vdd(results)
-  log_cpi_stack(results)
-
   # Run McPAT
   mcpat_run(tempfile, outputfile + '.txt')
+  power_dat = mcpat_parse(outputfile + '.txt', nuca_at_level)
+
+  # When sampling, part of this period may have been fast-forwarded without counting any activity
+  if partial:
+    extrapolate_power(power_dat, results['results'], outputfile + '.py')
 
-  # Parse output
-  power_txt = file(outputfile + '.txt')
+  # Fit the leakage curves for HotSpot's temperature-leakage loop once, from the static power at a higher temperature
+  cfg = results['config']
+  if sniper_config.get_config_default(cfg, 'periodic_thermal/leakage_feedback', 'false') == 'true' \
+     and not os.path.exists(os.path.join(sniper_config.get_config(cfg, 'general/output_dir'), 'LeakageBeta.txt')):
+    xml = file(tempfile).read()
+    xml = re.sub('name="temperature" value="[0-9]+"', 'name="temperature" value="%u"' % (MCPAT_TEMPERATURE + LEAKAGE_FIT_DELTA), xml)
+    file(tempfile + '-fit.xml', 'w').write(xml)
+    mcpat_run(tempfile + '-fit.xml', outputfile + '-fit.txt')
+    power_dat['LeakageFit'] = mcpat_parse(outputfile + '-fit.txt', nuca_at_level)
+
+  return power_dat
+
+
+def mcpat_parse(outputfile, nuca_at_level):
+  power_txt = file(outputfile)
   power_dat = {}
 
   components = power_txt.read().split('*'*89)[2:-1]
@@ -299,6 +306,34 @@ def main(jobid, resultsdir, outputfile, powertype = 'dynamic', config = None, no
   if not power_dat:
     raise ValueError('No valid McPAT output found')
 
+  return power_dat
+
+
+def main(jobid, resultsdir, outputfile, powertype = 'dynamic', config = None, no_graph = False, partial = None, print_stack = True, return_data = False, cached_power = None):
+  tempfile = outputfile + '.xml'
+
+  results = sniper_lib.get_results(jobid, resultsdir, partial = partial)
+  if config:
+    # update using energystats-temp.cfg
+    results['config'] = sniper_config.parse_config(file(config).read(), results['config'])
+
+    # recompute cycle counts with updated frequencies
+    _results = sniper_lib.parse_results_from_dir(resultsdir, partial=partial, metrics=None)
+    results['results'] = sniper_lib.stats_process(results['config'], _results)
+
+  # Log Performance Counters
+  log_frequencies(results)
+  log_vdd(results)
+  log_cpi_stack(results)
+
+  if cached_power:
+    # Power for this period was composed from earlier McPAT results by the caller (see scripts/energystats.py)
+    cached = {}
+    execfile(cached_power, {}, cached)
+    power_dat = cached['power']
+  else:
+    power_dat = mcpat_power(jobid, resultsdir, results, tempfile, outputfile, partial)
+
   # Add DRAM power
   dram_dyn, dram_stat = dram_power(results['results'], results['config'])
   power_dat['DRAM'] = {
@@ -309,6 +344,7 @@ def main(jobid, resultsdir, outputfile, powertype = 'dynamic', config = None, no
     'Gate Leakage': 0,
     'Area': 0,
   }
+  leakage_fit = power_dat.pop('LeakageFit', None)
   # Write back
   file(outputfile + '.py', 'w').write("power = " + pprint.pformat(power_dat))
 
@@ -318,7 +354,7 @@ def main(jobid, resultsdir, outputfile, powertype = 'dynamic', config = None, no
   time0_begin = results['results']['global.time_begin']
   time0_end = results['results']['global.time_end']
   seconds = (time0_end - time0_begin)/1e15
-  results = power_stack(power_dat,results['config'], powertype)
+  results = power_stack(power_dat,results['config'], powertype, leakage_fit = leakage_fit)
   # Plot stack
   plot_labels = []
   plot_data = {}
@@ -379,6 +415,33 @@ def main(jobid, resultsdir, outputfile, powertype = 'dynamic', config = None, no
     return {'labels': plot_labels, 'power_data': plot_data, 'ncores': ncores, 'time_s': seconds}
 
 
+def extrapolate_power(power_dat, stats, previousfile):
+  # Scale each core's dynamic power to its detailed-mode activity rate,
+  # or keep the previous period's estimate if the core was fast-forwarded for all of this period
+  if 'fastforward_performance_model.fastforwarded_time' not in stats:
+    return
+  previous = None
+  for core, values in enumerate(power_dat['Core']):
+    elapsed = stats['performance_model.elapsed_time'][core]
+    ffwd = stats['fastforward_performance_model.fastforwarded_time'][core]
+    if not ffwd or not elapsed:
+      continue
+    if elapsed > ffwd:
+      scale = elapsed / float(elapsed - ffwd)
+      for key in values:
+        if key.endswith('Runtime Dynamic'):
+          values[key] *= scale
+    else:
+      if previous is None:
+        previous = {}
+        if os.path.exists(previousfile):
+          execfile(previousfile, {}, previous)
+      if 'power' in previous:
+        for key in values:
+          if key.endswith('Runtime Dynamic'):
+            values[key] = previous['power']['Core'][core].get(key, values[key])
+
+
 def scale_power(suffix, power, size_nm):
   if suffix == 'Runtime Dynamic':
     if size_nm >= 22:
@@ -397,9 +460,9 @@ def scale_power(suffix, power, size_nm):
     raise Exception('do not know how to scale power: {}'.format(suffix))
 
 
-def power_stack(power_dat, cfg, powertype = 'total',  nocollapse = False):
+def power_stack(power_dat, cfg, powertype = 'total',  nocollapse = False, leakage_fit = None):
   size_nm = int(sniper_config.get_config(cfg, "power/technology_node"))
-  def getpower(powers, key = None):
+  def getpower(powers, key = None, powertype = powertype):
     def getcomponent(suffix):
       if key: return scale_power(suffix, powers.get(key+'/'+suffix, 0), size_nm)
       else: return scale_power(suffix, powers.get(suffix, 0), size_nm)
@@ -550,62 +613,66 @@ def power_stack(power_dat, cfg, powertype = 'total',  nocollapse = False):
 
   powerInstantaneousFileName.write (Headings+"\n")
    
-  Readings = ""
+  def get_readings(power_dat, getpower):
+    Readings = ""
 
-  L3Power = sum([ getpower(cache) for cache in power_dat.get('L3', []) ]) 
+    L3Power = sum([ getpower(cache) for cache in power_dat.get('L3', []) ]) 
 
-  if sniper_config.get_config_bool(cfg, "periodic_power/l3"):  
-    Readings += str(L3Power)+"\t"  # Private L3
+    if sniper_config.get_config_bool(cfg, "periodic_power/l3"):  
+      Readings += str(L3Power)+"\t"  # Private L3
   
-  amtCores = len(power_dat['Core'])
-  for i, core in enumerate(power_dat['Core']):
-    totalPower = getpower(core)
-    IFUPower =  getpower(core, 'Instruction Fetch Unit/Branch Predictor') + getpower(core, 'Instruction Fetch Unit/Branch Target Buffer') + getpower(core, 'Instruction Fetch Unit/Instruction Buffer') + getpower(core, 'Instruction Fetch Unit/Instruction Decoder') + getpower(core, 'Instruction Fetch Unit/Instruction Cache') 
-    LSUPower =  getpower(core, 'Load Store Unit/Data Cache') + getpower(core, 'Load Store Unit/LoadQ') + getpower(core, 'Load Store Unit/StoreQ')
-    EUPower = getpower(core, 'Execution Unit/Instruction Scheduler') + getpower(core, 'Execution Unit/Register Files') + getpower(core, 'Execution Unit/Results Broadcast Bus') + getpower(core, 'Execution Unit/Complex ALUs') + getpower(core, 'Execution Unit/Floating Point Units') + getpower(core, 'Execution Unit/Integer ALUs')
-
-    if sniper_config.get_config_bool(cfg, "periodic_power/l2"):  
-      Readings += str(getpower(core, 'L2'))+"\t"  # Private L2
-    if sniper_config.get_config_bool(cfg, "periodic_power/is"):
-      Readings += str(getpower(core, 'Execution Unit/Instruction Scheduler'))+"\t" # Instruction Scheduler
-    if sniper_config.get_config_bool(cfg, "periodic_power/rf"):
-      Readings += str(getpower(core, 'Execution Unit/Register Files'))+"\t"  # Register Files
-    if sniper_config.get_config_bool(cfg, "periodic_power/rbb"):
-      Readings += str(getpower(core, 'Execution Unit/Results Broadcast Bus'))+"\t"  # Result Broadcast Bus
-    if sniper_config.get_config_bool(cfg, "periodic_power/ru"):
-      Readings += str(getpower(core, 'Renaming Unit'))+"\t" # Renaming Unit
-    if sniper_config.get_config_bool(cfg, "periodic_power/bp"):
-      Readings += str(getpower(core, 'Instruction Fetch Unit/Branch Predictor'))+"\t"  # Branch Predictor
-    if sniper_config.get_config_bool(cfg, "periodic_power/btb"):
-      Readings += str(getpower(core, 'Instruction Fetch Unit/Branch Target Buffer'))+"\t"  # Branch Target Buffer
-    if sniper_config.get_config_bool(cfg, "periodic_power/ib"):
-      Readings += str(getpower(core, 'Instruction Fetch Unit/Instruction Buffer'))+"\t" # Instruction Buffer
-    if sniper_config.get_config_bool(cfg, "periodic_power/id"):
-      Readings += str(getpower(core, 'Instruction Fetch Unit/Instruction Decoder'))+"\t"  # Instruction Decoder
-    if sniper_config.get_config_bool(cfg, "periodic_power/ic"):
-      Readings += str(getpower(core, 'Instruction Fetch Unit/Instruction Cache'))+"\t"  # Instruction Cache
-    if sniper_config.get_config_bool(cfg, "periodic_power/dc"):
-      Readings += str(getpower(core, 'Load Store Unit/Data Cache'))+"\t" # Data Cache 
-    if sniper_config.get_config_bool(cfg, "periodic_power/calu"):
-      Readings += str(getpower(core, 'Execution Unit/Complex ALUs'))+"\t"  # Complex ALU
-    if sniper_config.get_config_bool(cfg, "periodic_power/falu"):
-      Readings += str(getpower(core, 'Execution Unit/Floating Point Units'))+"\t"  # Floating Point ALU
-    if sniper_config.get_config_bool(cfg, "periodic_power/ialu"):
-      Readings += str(getpower(core, 'Execution Unit/Integer ALUs'))+"\t"  # Integer ALU
-    if sniper_config.get_config_bool(cfg, "periodic_power/lu"): # Load Unit
-      Readings += str(getpower(core, 'Load Store Unit/LoadQ'))+"\t" 
-    if sniper_config.get_config_bool(cfg, "periodic_power/su"):  # Store Unit
-      Readings += str(getpower(core, 'Load Store Unit/StoreQ'))+"\t"  
-    if sniper_config.get_config_bool(cfg, "periodic_power/mmu"): # Memory Management Unit
-      Readings += str(getpower(core, 'Memory Management Unit'))+"\t"  # Memory Management Unit
-    if sniper_config.get_config_bool(cfg, "periodic_power/ifu"):
-      Readings += str(IFUPower) +"\t" # Instruction Fetch Unit
-    if sniper_config.get_config_bool(cfg, "periodic_power/lsu"):
-      Readings += str(LSUPower) +"\t"  # Load Store Unit
-    if sniper_config.get_config_bool(cfg, "periodic_power/eu"):
-      Readings += str(EUPower) +"\t"  # Execution Unit
-    if sniper_config.get_config_bool(cfg, "periodic_power/tp"):
-      Readings += str(totalPower) +"\t" # Total Power
+    amtCores = len(power_dat['Core'])
+    for i, core in enumerate(power_dat['Core']):
+      totalPower = getpower(core)
+      IFUPower =  getpower(core, 'Instruction Fetch Unit/Branch Predictor') + getpower(core, 'Instruction Fetch Unit/Branch Target Buffer') + getpower(core, 'Instruction Fetch Unit/Instruction Buffer') + getpower(core, 'Instruction Fetch Unit/Instruction Decoder') + getpower(core, 'Instruction Fetch Unit/Instruction Cache') 
+      LSUPower =  getpower(core, 'Load Store Unit/Data Cache') + getpower(core, 'Load Store Unit/LoadQ') + getpower(core, 'Load Store Unit/StoreQ')
+      EUPower = getpower(core, 'Execution Unit/Instruction Scheduler') + getpower(core, 'Execution Unit/Register Files') + getpower(core, 'Execution Unit/Results Broadcast Bus') + getpower(core, 'Execution Unit/Complex ALUs') + getpower(core, 'Execution Unit/Floating Point Units') + getpower(core, 'Execution Unit/Integer ALUs')
+
+      if sniper_config.get_config_bool(cfg, "periodic_power/l2"):  
+        Readings += str(getpower(core, 'L2'))+"\t"  # Private L2
+      if sniper_config.get_config_bool(cfg, "periodic_power/is"):
+        Readings += str(getpower(core, 'Execution Unit/Instruction Scheduler'))+"\t" # Instruction Scheduler
+      if sniper_config.get_config_bool(cfg, "periodic_power/rf"):
+        Readings += str(getpower(core, 'Execution Unit/Register Files'))+"\t"  # Register Files
+      if sniper_config.get_config_bool(cfg, "periodic_power/rbb"):
+        Readings += str(getpower(core, 'Execution Unit/Results Broadcast Bus'))+"\t"  # Result Broadcast Bus
+      if sniper_config.get_config_bool(cfg, "periodic_power/ru"):
+        Readings += str(getpower(core, 'Renaming Unit'))+"\t" # Renaming Unit
+      if sniper_config.get_config_bool(cfg, "periodic_power/bp"):
+        Readings += str(getpower(core, 'Instruction Fetch Unit/Branch Predictor'))+"\t"  # Branch Predictor
+      if sniper_config.get_config_bool(cfg, "periodic_power/btb"):
+        Readings += str(getpower(core, 'Instruction Fetch Unit/Branch Target Buffer'))+"\t"  # Branch Target Buffer
+      if sniper_config.get_config_bool(cfg, "periodic_power/ib"):
+        Readings += str(getpower(core, 'Instruction Fetch Unit/Instruction Buffer'))+"\t" # Instruction Buffer
+      if sniper_config.get_config_bool(cfg, "periodic_power/id"):
+        Readings += str(getpower(core, 'Instruction Fetch Unit/Instruction Decoder'))+"\t"  # Instruction Decoder
+      if sniper_config.get_config_bool(cfg, "periodic_power/ic"):
+        Readings += str(getpower(core, 'Instruction Fetch Unit/Instruction Cache'))+"\t"  # Instruction Cache
+      if sniper_config.get_config_bool(cfg, "periodic_power/dc"):
+        Readings += str(getpower(core, 'Load Store Unit/Data Cache'))+"\t" # Data Cache 
+      if sniper_config.get_config_bool(cfg, "periodic_power/calu"):
+        Readings += str(getpower(core, 'Execution Unit/Complex ALUs'))+"\t"  # Complex ALU
+      if sniper_config.get_config_bool(cfg, "periodic_power/falu"):
+        Readings += str(getpower(core, 'Execution Unit/Floating Point Units'))+"\t"  # Floating Point ALU
+      if sniper_config.get_config_bool(cfg, "periodic_power/ialu"):
+        Readings += str(getpower(core, 'Execution Unit/Integer ALUs'))+"\t"  # Integer ALU
+      if sniper_config.get_config_bool(cfg, "periodic_power/lu"): # Load Unit
+        Readings += str(getpower(core, 'Load Store Unit/LoadQ'))+"\t" 
+      if sniper_config.get_config_bool(cfg, "periodic_power/su"):  # Store Unit
+        Readings += str(getpower(core, 'Load Store Unit/StoreQ'))+"\t"  
+      if sniper_config.get_config_bool(cfg, "periodic_power/mmu"): # Memory Management Unit
+        Readings += str(getpower(core, 'Memory Management Unit'))+"\t"  # Memory Management Unit
+      if sniper_config.get_config_bool(cfg, "periodic_power/ifu"):
+        Readings += str(IFUPower) +"\t" # Instruction Fetch Unit
+      if sniper_config.get_config_bool(cfg, "periodic_power/lsu"):
+        Readings += str(LSUPower) +"\t"  # Load Store Unit
+      if sniper_config.get_config_bool(cfg, "periodic_power/eu"):
+        Readings += str(EUPower) +"\t"  # Execution Unit
+      if sniper_config.get_config_bool(cfg, "periodic_power/tp"):
+        Readings += str(totalPower) +"\t" # Total Power
+    return Readings
+
+  Readings = get_readings(power_dat, getpower)
 
   powerInstantaneousFileName.write (Readings+"\n")
   powerInstantaneousFileName.close ()
@@ -613,6 +680,23 @@ def power_stack(power_dat, cfg, powertype = 'total',  nocollapse = False):
   powerLogFileName.write (Readings+"\n")
   powerLogFileName.close()
 
+  # Static power of every block at MCPAT_TEMPERATURE, and its growth with temperature, for HotSpot's leakage loop
+  leakage_feedback = sniper_config.get_config_default(cfg, "periodic_thermal/leakage_feedback", "false") == 'true'
+  if leakage_feedback:
+    getstatic = lambda powers, key = None: getpower(powers, key, 'static')
+    leakage = map(float, get_readings(power_dat, getstatic).split())
+    output_dir = sniper_config.get_config(cfg, "general/output_dir")
+    with open(os.path.join(output_dir, 'LeakagePower.txt'), 'w') as f:
+      for name, value in zip(Headings.split(), leakage):
+        f.write('%s\t%s\n' % (name, value))
+    if leakage_fit:
+      # Exponential fit through the static power at both temperatures
+      leakage_hot = map(float, get_readings(leakage_fit, getstatic).split())
+      with open(os.path.join(output_dir, 'LeakageBeta.txt'), 'w') as f:
+        for name, ref, hot in zip(Headings.split(), leakage, leakage_hot):
+          beta = math.log(hot / ref) / LEAKAGE_FIT_DELTA if ref > 0 and hot > 0 else 0
+          f.write('%s\t%s\n' % (name, beta))
+
 
   if (sniper_config.get_config(cfg, "periodic_thermal/enabled") == 'true'):
 
@@ -634,8 +718,16 @@ def power_stack(power_dat, cfg, powertype = 'total',  nocollapse = False):
                   '-sampling_intvl', str(interval_s),
                   '-p', os.path.join(sniper_config.get_config(cfg, "general/output_dir"), 'InstantaneousPower.log'),
                   '-o', os.path.join(sniper_config.get_config(cfg, "general/output_dir"), 'InstantaneousTemperature.log')]
-   if not needInitializing:
-     hotspot_args += ['-init_file', os.path.join(sniper_config.get_config(cfg, "general/output_dir"), 'Temperature.init')]
+   # After a checkpoint restore, Temperature.init holds the temperatures at the time the checkpoint was taken
+   init_file = os.path.join(sniper_config.get_config(cfg, "general/output_dir"), 'Temperature.init')
+   if not needInitializing or (sniper_config.get_config_default(cfg, "checkpoint/restore", "") not in ("", '""') and os.path.exists(init_file)):
+     hotspot_args += ['-init_file', init_file]
+   if leakage_feedback:
+     hotspot_args += ['-leakage_used', '1',
+                      '-leakage_mode', '2',
+                      '-leakage_power_file', os.path.join(sniper_config.get_config(cfg, "general/output_dir"), 'LeakagePower.txt'),
+                      '-leakage_beta_file', os.path.join(sniper_config.get_config(cfg, "general/output_dir"), 'LeakageBeta.txt'),
+                      '-leakage_tref', str(MCPAT_TEMPERATURE)]
 
    temperatures = subprocess.check_output([hotspot_binary] + hotspot_args)
    with open(os.path.join(sniper_config.get_config(cfg, "general/output_dir"), 'Temperature.init'), 'w') as f:
@@ -1131,7 +1223,7 @@ def readTemplate(ncores, num_l2s, private_l2s, num_l3s, technology_node):
   template.append(["\t\t<param name=\"homogeneous_NoCs\" value=\"1\"/>",""])
   template.append(["\t\t<param name=\"core_tech_node\" value=\"%u\"/><!-- nm -->"%technology_node,""])
   template.append(["\t\t<param name=\"target_core_clockrate\" value='%i'/><!--MHz -->",["core_clock","cfg",None]]) #CFG
-  template.append(["\t\t<param name=\"temperature\" value=\"330\"/> <!-- Kelvin -->",""])
+  template.append(["\t\t<param name=\"temperature\" value=\"%u\"/> <!-- Kelvin -->"%MCPAT_TEMPERATURE,""])
   template.append(["\t\t<param name=\"number_cache_levels\" value=\"3\"/>",""])
   template.append(["\t\t<param name=\"interconnect_projection_type\" value=\"0\"/><!--0: agressive wire technology; 1: conservative wire technology -->",""])
   template.append(["\t\t<param name=\"device_type\" value=\"{:d}\"/><!--0: HP(High Performance Type); 1: LSTP(Low standby power) 2: LOP (Low Operating Power)  -->".format(device_type),""])
@@ -1589,9 +1681,10 @@ if __name__ == '__main__':
   no_graph = False
   no_text = False
   partial = None
+  cached_power = None
 
   try:
-    opts, args = getopt.getopt(sys.argv[1:], "hj:t:c:d:o:", [ 'no-graph', 'no-text', 'partial=' ])
+    opts, args = getopt.getopt(sys.argv[1:], "hj:t:c:d:o:", [ 'no-graph', 'no-text', 'partial=', 'cached-power=' ])
   except getopt.GetoptError, e:
     print e
     usage()
@@ -1620,6 +1713,8 @@ if __name__ == '__main__':
         sys.stderr.write('--partial=<from>:<to>\n')
         usage()
       partial = a.split(':')
+    if o == '--cached-power':
+      cached_power = a
 
 
-  main(jobid = jobid, resultsdir = resultsdir, powertype = powertype, config = config, outputfile = outputfile, no_graph = no_graph, print_stack = not no_text, partial = partial)
+  main(jobid = jobid, resultsdir = resultsdir, powertype = powertype, config = config, outputfile = outputfile, no_graph = no_graph, print_stack = not no_text, partial = partial, cached_power = cached_power)